@@ -278,6 +278,8 @@ set (bscript_sources    # sorted !
   compiler/optimizer/ReferencedFunctionGatherer.h
   compiler/optimizer/UnaryOperatorOptimizer.cpp
   compiler/optimizer/UnaryOperatorOptimizer.h
+  compiler/optimizer/UnreachableCodeRemover.cpp
+  compiler/optimizer/UnreachableCodeRemover.h
   compiler/optimizer/ValueConsumerOptimizer.cpp
   compiler/optimizer/ValueConsumerOptimizer.h
   compiler/representation/CompiledScript.cpp
@@ -348,6 +350,8 @@ set (bscript_sources    # sorted !
   objstrm.cpp
   operator.h
   options.h
+  scriptprofile.cpp
+  scriptprofile.h
   str.cpp
   str.h
   symcont.cpp
@@ -10,6 +10,7 @@
 
 #include "bstruct.h"
 
+#include <mutex>
 #include <stddef.h>
 
 #include "../clib/passert.h"
@@ -17,6 +18,7 @@
 #include "berror.h"
 #include "bobject.h"
 #include "contiter.h"
+#include "eprog.h"
 #include "executor.h"
 #include "impstr.h"
 #include "objmethods.h"
@@ -25,23 +27,134 @@ namespace Pol
 {
 namespace Bscript
 {
-BStruct::BStruct() : BObjectImp( OTStruct ), contents_() {}
+namespace
+{
+// guards the shape transitions and the intern table, shapes themselves are immutable
+std::mutex shape_mutex;
+
+std::map<std::vector<std::string>, const StructShape*>& interned_shapes()
+{
+  static std::map<std::vector<std::string>, const StructShape*> shapes;
+  return shapes;
+}
+}  // namespace
 
-BStruct::BStruct( BObjectType type ) : BObjectImp( type ), contents_() {}
+StructShape::StructShape( std::vector<std::string> names, u32 id )
+    : names_( std::move( names ) ), id_( id ), added_(), removed_()
+{
+}
 
-BStruct::BStruct( const BStruct& other, BObjectType type ) : BObjectImp( type ), contents_()
+const StructShape* StructShape::empty()
 {
-  for ( const auto& elem : other.contents_ )
+  static const StructShape* shape = []()
   {
-    const std::string& key = elem.first;
-    const BObjectRef& bvalref = elem.second;
+    std::lock_guard<std::mutex> lock( shape_mutex );
+    return intern( std::vector<std::string>() );
+  }();
+  return shape;
+}
 
-    contents_[key] = BObjectRef( new BObject( bvalref->impref().copy() ) );
+size_t StructShape::shared_count()
+{
+  std::lock_guard<std::mutex> lock( shape_mutex );
+  return interned_shapes().size();
+}
+
+const StructShape* StructShape::intern( std::vector<std::string>&& names )
+{
+  static u32 next_id = 1;
+  auto& shapes = interned_shapes();
+  auto itr = shapes.find( names );
+  if ( itr != shapes.end() )
+    return itr->second;
+  if ( shapes.size() >= MAX_SHARED_SHAPES )
+    return nullptr;
+  // never freed: caches and transitions of other shapes may still point to it
+  auto* shape = new StructShape( names, next_id++ );
+  shapes.emplace( std::move( names ), shape );
+  return shape;
+}
+
+size_t StructShape::find( const char* name ) const
+{
+  size_t index = insert_position( name );
+  if ( index < names_.size() && stricmp( names_[index].c_str(), name ) == 0 )
+    return index;
+  return npos;
+}
+
+size_t StructShape::insert_position( const char* name ) const
+{
+  size_t lo = 0;
+  size_t hi = names_.size();
+  while ( lo < hi )
+  {
+    size_t mid = lo + ( hi - lo ) / 2;
+    if ( stricmp( names_[mid].c_str(), name ) < 0 )
+      lo = mid + 1;
+    else
+      hi = mid;
   }
+  return lo;
+}
+
+const StructShape* StructShape::with_member( const std::string& name, size_t index ) const
+{
+  if ( names_.size() >= MAX_SHARED_MEMBERS )
+    return nullptr;
+  std::lock_guard<std::mutex> lock( shape_mutex );
+  auto itr = added_.find( name );
+  if ( itr != added_.end() )
+    return itr->second;
+  std::vector<std::string> names;
+  names.reserve( names_.size() + 1 );
+  names.insert( names.end(), names_.begin(), names_.begin() + index );
+  names.push_back( name );
+  names.insert( names.end(), names_.begin() + index, names_.end() );
+  const StructShape* shape = intern( std::move( names ) );
+  if ( shape != nullptr )
+    added_.emplace( name, shape );
+  return shape;
+}
+
+const StructShape* StructShape::without_member( size_t index ) const
+{
+  std::lock_guard<std::mutex> lock( shape_mutex );
+  if ( removed_.empty() )
+    removed_.resize( names_.size(), nullptr );
+  if ( removed_[index] != nullptr )
+    return removed_[index];
+  std::vector<std::string> names( names_ );
+  names.erase( names.begin() + index );
+  removed_[index] = intern( std::move( names ) );
+  return removed_[index];
+}
+
+BStruct::BStruct()
+    : BObjectImp( OTStruct ), shape_( StructShape::empty() ), owned_shape_(), values_()
+{
+}
+
+BStruct::BStruct( BObjectType type )
+    : BObjectImp( type ), shape_( StructShape::empty() ), owned_shape_(), values_()
+{
+}
+
+BStruct::BStruct( const BStruct& other, BObjectType type )
+    : BObjectImp( type ), shape_( other.shape_ ), owned_shape_(), values_()
+{
+  if ( other.owned_shape_ )
+  {
+    owned_shape_.reset( new StructShape( other.owned_shape_->names_, 0 ) );
+    shape_ = owned_shape_.get();
+  }
+  values_.reserve( other.values_.size() );
+  for ( const auto& bvalref : other.values_ )
+    values_.emplace_back( new BObject( bvalref->impref().copy() ) );
 }
 
 BStruct::BStruct( std::istream& is, unsigned size, BObjectType type )
-    : BObjectImp( type ), contents_()
+    : BObjectImp( type ), shape_( StructShape::empty() ), owned_shape_(), values_()
 {
   for ( unsigned i = 0; i < size; ++i )
   {
@@ -49,7 +162,7 @@ BStruct::BStruct( std::istream& is, unsigned size, BObjectType type )
     BObjectImp* valimp = BObjectImp::unpack( is );
     if ( auto* key = impptrIf<String>( keyimp ); valimp && key )
     {
-      contents_[key->value()].set( new BObject( valimp ) );
+      put_member( key->value(), BObjectRef( new BObject( valimp ) ) );
 
       BObject cleaner( key );
     }
@@ -63,6 +176,57 @@ BStruct::BStruct( std::istream& is, unsigned size, BObjectType type )
   }
 }
 
+size_t BStruct::find_member( const char* name ) const
+{
+  return shape_->find( name );
+}
+
+size_t BStruct::put_member( const std::string& name, BObjectRef val )
+{
+  size_t index = shape_->find( name.c_str() );
+  if ( index != StructShape::npos )
+  {
+    values_[index] = std::move( val );
+    return index;
+  }
+  index = shape_->insert_position( name.c_str() );
+  const StructShape* next = owned_shape_ ? nullptr : shape_->with_member( name, index );
+  if ( next != nullptr )
+  {
+    shape_ = next;
+  }
+  else
+  {
+    if ( !owned_shape_ )
+    {
+      owned_shape_.reset( new StructShape( shape_->names_, 0 ) );
+      shape_ = owned_shape_.get();
+    }
+    owned_shape_->names_.insert( owned_shape_->names_.begin() + index, name );
+  }
+  values_.insert( values_.begin() + index, std::move( val ) );
+  return index;
+}
+
+void BStruct::erase_member( size_t index )
+{
+  const StructShape* next = owned_shape_ ? nullptr : shape_->without_member( index );
+  if ( next != nullptr )
+  {
+    shape_ = next;
+  }
+  else
+  {
+    if ( !owned_shape_ )
+    {
+      owned_shape_.reset( new StructShape( shape_->names_, 0 ) );
+      shape_ = owned_shape_.get();
+    }
+    owned_shape_->names_.erase( owned_shape_->names_.begin() + index );
+  }
+  values_.erase( values_.begin() + index );
+}
+
 BObjectImp* BStruct::copy() const
 {
   passert( isa( OTStruct ) );
@@ -138,34 +302,27 @@ BStructIterator::BStructIterator( BStruct* pStruct, BObject* pIterVal )
 
 BObject* BStructIterator::step()
 {
+  size_t index = 0;
   if ( m_First )
   {
-    auto itr = m_pStruct->contents_.begin();
-    if ( itr == m_pStruct->contents_.end() )
-      return nullptr;
-
     m_First = false;
-    key = ( *itr ).first;
-    m_IterVal->setimp( new String( key ) );
-
-    BObjectRef& oref = ( *itr ).second;
-    return oref.get();
   }
   else
   {
-    auto itr = m_pStruct->contents_.find( key );
-    if ( itr == m_pStruct->contents_.end() )
-      return nullptr;
-    ++itr;
-    if ( itr == m_pStruct->contents_.end() )
+    // the struct may have changed since the last step, continue after the current key
+    index = m_pStruct->find_member( key.c_str() );
+    if ( index == StructShape::npos )
       return nullptr;
+    ++index;
+  }
+  if ( index >= m_pStruct->values_.size() )
+    return nullptr;
 
-    key = ( *itr ).first;
-    m_IterVal->setimp( new String( key ) );
+  key = m_pStruct->shape_->name( index );
+  m_IterVal->setimp( new String( key ) );
 
-    BObjectRef& oref = ( *itr ).second;
-    return oref.get();
-  }
+  BObjectRef& oref = m_pStruct->values_[index];
+  return oref.get();
 }
 
 ContIterator* BStruct::createIterator( BObject* pIterVal )
@@ -175,31 +332,38 @@ ContIterator* BStruct::createIterator( BObject* pIterVal )
 
 size_t BStruct::sizeEstimate() const
 {
-  return sizeof( BStruct ) +
-         Clib::memsize( contents_, []( const auto& v ) { return v.sizeEstimate(); } );
+  // shared shapes are accounted nowhere, they are reused by all structs with the same members
+  size_t size = sizeof( BStruct ) +
+                Clib::memsize( values_, []( const auto& v ) { return v.sizeEstimate(); } );
+  if ( owned_shape_ )
+  {
+    size += sizeof( StructShape ) + Clib::memsize( owned_shape_->names_ );
+    for ( const auto& name : owned_shape_->names_ )
+      size += name.capacity();
+  }
+  return size;
 }
 
 size_t BStruct::mapcount() const
 {
-  return contents_.size();
+  return values_.size();
 }
 
 
 BObjectRef BStruct::set_member( const char* membername, BObjectImp* value, bool copy )
 {
-  std::string key( membername );
   BObjectImp* target = copy ? value->copy() : value;
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  size_t index = find_member( membername );
+  if ( index != StructShape::npos )
   {
-    BObjectRef& oref = ( *itr ).second;
+    BObjectRef& oref = values_[index];
     oref->setimp( target );
     return oref;
   }
   else
   {
     BObjectRef ref( new BObject( target ) );
-    contents_[key] = ref;
+    put_member( membername, ref );
     return ref;
   }
 }
@@ -207,12 +371,10 @@ BObjectRef BStruct::set_member( const char* membername, BObjectImp* value, bool
 // used programmatically
 const BObjectImp* BStruct::FindMember( const char* name )
 {
-  std::string key( name );
-
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  size_t index = find_member( name );
+  if ( index != StructShape::npos )
   {
-    return ( *itr ).second->impptr();
+    return values_[index]->impptr();
   }
   else
   {
@@ -222,12 +384,10 @@ const BObjectImp* BStruct::FindMember( const char* name )
 
 BObjectRef BStruct::get_member( const char* membername )
 {
-  std::string key( membername );
-
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  size_t index = find_member( membername );
+  if ( index != StructShape::npos )
   {
-    return ( *itr ).second;
+    return values_[index];
   }
   else
   {
@@ -235,16 +395,44 @@ BObjectRef BStruct::get_member( const char* membername )
   }
 }
 
+BObjectRef BStruct::get_member_cached( const char* membername, MemberCache& cache )
+{
+  size_t index;
+  if ( cache.lookup( shape_->id(), index ) )
+    return values_[index];
+  index = find_member( membername );
+  if ( index == StructShape::npos )
+    return BObjectRef( UninitObject::create() );
+  cache.remember( shape_->id(), index );
+  return values_[index];
+}
+
+BObjectRef BStruct::set_member_cached( const char* membername, BObjectImp* value, bool copy,
+                                       MemberCache& cache )
+{
+  size_t index;
+  if ( !cache.lookup( shape_->id(), index ) )
+  {
+    index = find_member( membername );
+    if ( index == StructShape::npos )
+      index = put_member( membername, BObjectRef( new BObject( UninitObject::create() ) ) );
+    cache.remember( shape_->id(), index );
+  }
+  BObjectRef& oref = values_[index];
+  oref->setimp( copy ? value->copy() : value );
+  return oref;
+}
+
 BObjectRef BStruct::OperSubscript( const BObject& obj )
 {
   if ( obj->isa( OTString ) )
   {
     const String* keystr = obj.impptr<String>();
 
-    auto itr = contents_.find( keystr->value() );
-    if ( itr != contents_.end() )
+    size_t index = find_member( keystr->data() );
+    if ( index != StructShape::npos )
     {
-      BObjectRef& oref = ( *itr ).second;
+      BObjectRef& oref = values_[index];
       return oref;
     }
     else
@@ -268,16 +456,16 @@ BObjectImp* BStruct::array_assign( BObjectImp* idx, BObjectImp* target, bool cop
   {
     BObjectImp* new_target = copy ? target->copy() : target;
 
-    auto itr = contents_.find( key->value() );
-    if ( itr != contents_.end() )
+    size_t index = find_member( key->data() );
+    if ( index != StructShape::npos )
     {
-      BObjectRef& oref = ( *itr ).second;
+      BObjectRef& oref = values_[index];
       oref->setimp( new_target );
       return new_target;
     }
     else
     {
-      contents_[key->value()].set( new BObject( new_target ) );
+      put_member( key->value(), BObjectRef( new BObject( new_target ) ) );
       return new_target;
     }
   }
@@ -294,14 +482,12 @@ BObjectImp* BStruct::array_assign( BObjectImp* idx, BObjectImp* target, bool cop
 
 void BStruct::addMember( const char* name, BObjectRef val )
 {
-  std::string key( name );
-  contents_[key] = val;
+  put_member( name, std::move( val ) );
 }
 
 void BStruct::addMember( const char* name, BObjectImp* imp )
 {
-  std::string key( name );
-  contents_[key] = BObjectRef( imp );
+  put_member( name, BObjectRef( imp ) );
 }
 
 BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebuiltin*/ )
@@ -312,7 +498,7 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
   {
   case MTH_SIZE:
     if ( ex.numParams() == 0 )
-      return new BLong( static_cast<int>( contents_.size() ) );
+      return new BLong( static_cast<int>( values_.size() ) );
     else
       return new BError( "struct.size() doesn't take parameters." );
 
@@ -322,8 +508,11 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       if ( !keyobj->isa( OTString ) )
         return new BError( "Struct keys must be strings" );
       String* strkey = keyobj->impptr<String>();
-      int nremove = static_cast<int>( contents_.erase( strkey->value() ) );
-      return new BLong( nremove );
+      size_t index = find_member( strkey->data() );
+      if ( index == StructShape::npos )
+        return new BLong( 0 );
+      erase_member( index );
+      return new BLong( 1 );
     }
     else
     {
@@ -337,8 +526,8 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       if ( !keyobj->isa( OTString ) )
         return new BError( "Struct keys must be strings" );
       String* strkey = keyobj->impptr<String>();
-      contents_[strkey->value()] = BObjectRef( new BObject( valobj->impptr()->copy() ) );
-      return new BLong( static_cast<int>( contents_.size() ) );
+      put_member( strkey->value(), BObjectRef( new BObject( ex.takeParamImp( 1 ) ) ) );
+      return new BLong( static_cast<int>( values_.size() ) );
     }
     else
     {
@@ -351,7 +540,7 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       if ( !keyobj->isa( OTString ) )
         return new BError( "Struct keys must be strings" );
       String* strkey = keyobj->impptr<String>();
-      int count = static_cast<int>( contents_.count( strkey->value() ) );
+      int count = find_member( strkey->data() ) != StructShape::npos ? 1 : 0;
       return new BLong( count );
     }
     else
@@ -363,9 +552,9 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
     if ( ex.numParams() == 0 )
     {
       std::unique_ptr<ObjArray> arr( new ObjArray );
-      for ( const auto& content : contents_ )
+      for ( size_t i = 0; i < shape_->size(); ++i )
       {
-        arr->addElement( new String( content.first ) );
+        arr->addElement( new String( shape_->name( i ) ) );
       }
       return arr.release();
     }
@@ -388,11 +577,11 @@ BObjectImp* BStruct::call_method( const char* methodname, Executor& ex )
 
 void BStruct::packonto( std::ostream& os ) const
 {
-  os << packtype() << contents_.size() << ":";
-  for ( const auto& content : contents_ )
+  os << packtype() << values_.size() << ":";
+  for ( size_t i = 0; i < values_.size(); ++i )
   {
-    const std::string& key = content.first;
-    const BObjectRef& bvalref = content.second;
+    const std::string& key = shape_->name( i );
+    const BObjectRef& bvalref = values_[i];
 
     String::packonto( os, key );
     bvalref->impref().packonto( os );
@@ -405,10 +594,10 @@ std::string BStruct::getStringRep() const
   os << typetag() << "{ ";
   bool any = false;
 
-  for ( const auto& content : contents_ )
+  for ( size_t i = 0; i < values_.size(); ++i )
   {
-    const std::string& key = content.first;
-    const BObjectRef& bvalref = content.second;
+    const std::string& key = shape_->name( i );
+    const BObjectRef& bvalref = values_[i];
 
     if ( any )
       os << ", ";
@@ -426,11 +615,10 @@ std::string BStruct::getStringRep() const
 
 BObjectRef BStruct::operDotPlus( const char* name )
 {
-  std::string key( name );
-  if ( contents_.count( key ) == 0 )
+  if ( find_member( name ) == StructShape::npos )
   {
     auto pnewobj = new BObject( new UninitObject );
-    contents_[key] = BObjectRef( pnewobj );
+    put_member( name, BObjectRef( pnewobj ) );
     return BObjectRef( pnewobj );
   }
   else
@@ -441,21 +629,21 @@ BObjectRef BStruct::operDotPlus( const char* name )
 
 BObjectRef BStruct::operDotMinus( const char* name )
 {
-  std::string key( name );
-  contents_.erase( key );
+  size_t index = find_member( name );
+  if ( index != StructShape::npos )
+    erase_member( index );
   return BObjectRef( new BLong( 1 ) );
 }
 
 BObjectRef BStruct::operDotQMark( const char* name )
 {
-  std::string key( name );
-  int count = static_cast<int>( contents_.count( key ) );
+  int count = find_member( name ) != StructShape::npos ? 1 : 0;
   return BObjectRef( new BLong( count ) );
 }
 
-const BStruct::Contents& BStruct::contents() const
+BStruct::Contents BStruct::contents() const
 {
-  return contents_;
+  return Contents( *this );
 }
 }  // namespace Bscript
 }  // namespace Pol
@@ -14,8 +14,12 @@
 #endif
 
 #include <iosfwd>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "../clib/maputil.h"
 #include "../clib/rawtypes.h"
@@ -26,6 +30,7 @@ namespace Bscript
 {
 class ContIterator;
 class Executor;
+class MemberCache;
 }  // namespace Bscript
 }  // namespace Pol
 
@@ -33,6 +38,51 @@ namespace Pol
 {
 namespace Bscript
 {
+/**
+ * Member layout of structs: the member names sorted case-insensitively, which is also the
+ * iteration order of a struct. Structs with the same members share one shape and store only
+ * their values.
+ *
+ * Shared shapes are immutable and never freed, adding or removing a member switches the struct to
+ * the successor shape, which is remembered by its predecessor. Structs with too many members or
+ * created after the shape limit got reached own a private shape (id 0) which they modify in
+ * place, they never hit inline caches.
+ */
+class StructShape
+{
+public:
+  static constexpr size_t npos = ~static_cast<size_t>( 0 );
+  static constexpr size_t MAX_SHARED_MEMBERS = 64;
+  static constexpr size_t MAX_SHARED_SHAPES = 100000;
+
+  static const StructShape* empty();
+  static size_t shared_count();
+
+  u32 id() const { return id_; }
+  size_t size() const { return names_.size(); }
+  const std::string& name( size_t index ) const { return names_[index]; }
+  // index of the member, case-insensitive
+  size_t find( const char* name ) const;
+  // index a new member with this name would get
+  size_t insert_position( const char* name ) const;
+
+private:
+  friend class BStruct;
+  StructShape( std::vector<std::string> names, u32 id );
+  // requires the shape mutex, nullptr if the limit of shared shapes is reached
+  static const StructShape* intern( std::vector<std::string>&& names );
+
+  // successors, nullptr if this shape may not get shared
+  const StructShape* with_member( const std::string& name, size_t index ) const;
+  const StructShape* without_member( size_t index ) const;
+
+  std::vector<std::string> names_;
+  u32 id_;
+  // guarded by the shape mutex
+  mutable std::map<std::string, const StructShape*> added_;
+  mutable std::vector<const StructShape*> removed_;
+};
+
 class BStruct : public BObjectImp
 {
 public:
@@ -47,8 +97,70 @@ public:
 
   size_t mapcount() const;
 
-  typedef std::map<std::string, BObjectRef, Clib::ci_cmp_pred> Contents;
-  const Contents& contents() const;
+  /**
+   * Read-only view of the members as (name, value) pairs in key order
+   */
+  class Contents
+  {
+  public:
+    typedef std::pair<const std::string&, const BObjectRef&> value_type;
+    class const_iterator
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef BStruct::Contents::value_type value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const value_type* pointer;
+      typedef value_type reference;
+      struct arrow_proxy
+      {
+        value_type value;
+        const value_type* operator->() const { return &value; }
+      };
+
+      const_iterator() : struct_( nullptr ), index_( 0 ) {}
+      const_iterator( const BStruct* bstruct, size_t index ) : struct_( bstruct ), index_( index )
+      {
+      }
+      value_type operator*() const
+      {
+        return value_type( struct_->shape_->name( index_ ), struct_->values_[index_] );
+      }
+      arrow_proxy operator->() const { return arrow_proxy{ **this }; }
+      const_iterator& operator++()
+      {
+        ++index_;
+        return *this;
+      }
+      const_iterator operator++( int )
+      {
+        const_iterator tmp = *this;
+        ++index_;
+        return tmp;
+      }
+      bool operator==( const const_iterator& other ) const { return index_ == other.index_; }
+      bool operator!=( const const_iterator& other ) const { return index_ != other.index_; }
+
+    private:
+      const BStruct* struct_;
+      size_t index_;
+    };
+
+    explicit Contents( const BStruct& bstruct ) : struct_( bstruct ) {}
+    const_iterator begin() const { return const_iterator( &struct_, 0 ); }
+    const_iterator end() const { return const_iterator( &struct_, struct_.values_.size() ); }
+    size_t size() const { return struct_.values_.size(); }
+    bool empty() const { return struct_.values_.empty(); }
+
+  private:
+    const BStruct& struct_;
+  };
+  Contents contents() const;
+
+  // member access of the executor, remembers shape and index of the last struct in the cache
+  BObjectRef get_member_cached( const char* membername, MemberCache& cache );
+  BObjectRef set_member_cached( const char* membername, BObjectImp* value, bool copy,
+                                MemberCache& cache );
 
 protected:
   explicit BStruct( const BStruct& other, BObjectType type );
@@ -84,7 +196,14 @@ protected:
   friend class BStructIterator;
 
 private:
-  Contents contents_;
+  size_t find_member( const char* name ) const;
+  // replaces the value of an existing member, returns the index of the member
+  size_t put_member( const std::string& name, BObjectRef val );
+  void erase_member( size_t index );
+
+  const StructShape* shape_;
+  std::unique_ptr<StructShape> owned_shape_;
+  std::vector<BObjectRef> values_;
   BStruct& operator=( const BStruct& );  // not implemented
 };
 }
@@ -1,5 +1,7 @@
 #include "Compiler.h"
 
+#include <fstream>
+
 #include "bscript/compiler/Profile.h"
 #include "bscript/compiler/Report.h"
 #include "bscript/compiler/analyzer/Disambiguator.h"
@@ -14,11 +16,14 @@
 #include "bscript/compiler/format/ListingWriter.h"
 #include "bscript/compiler/model/CompilerWorkspace.h"
 #include "bscript/compiler/optimizer/Optimizer.h"
+#include "bscript/compiler/optimizer/UnreachableCodeRemover.h"
 #include "bscript/compiler/representation/CompiledScript.h"
 #include "clib/fileutil.h"
 #include "clib/logfacility.h"
+#include "clib/rawtypes.h"
 #include "clib/timer.h"
 #include "compilercfg.h"
+#include "filefmt.h"
 
 namespace Pol::Bscript::Compiler
 {
@@ -70,9 +75,29 @@ void Compiler::write_included_filenames( const std::string& pathname )
     std::ofstream ofs( pathname );
     for ( auto& r : output->source_file_identifiers )
     {
-      ofs << r->pathname << "\n";
+      ofs << r->pathname << '\t' << content_hash( r->pathname ) << "\n";
+    }
+  }
+}
+
+std::string Compiler::content_hash( const std::string& pathname )
+{
+  std::ifstream ifs( pathname, std::ios::binary );
+  if ( !ifs.is_open() )
+    return {};
+
+  // FNV-1a, seeded with the format version so that a new compiler recompiles everything
+  u64 hash = 14695981039346656037ull ^ ESCRIPT_FILE_VER_CURRENT;
+  char buf[4096];
+  while ( ifs.read( buf, sizeof buf ) || ifs.gcount() )
+  {
+    for ( std::streamsize i = 0; i < ifs.gcount(); ++i )
+    {
+      hash ^= static_cast<unsigned char>( buf[i] );
+      hash *= 1099511628211ull;
     }
   }
+  return fmt::format( "{:016x}", hash );
 }
 
 void Compiler::set_include_compile_mode()
@@ -125,6 +150,8 @@ void Compiler::compile_file_steps( const std::string& pathname, Report& report )
   if ( report.error_count() )
     return;
 
+  remove_unreachable_code( *workspace );
+
   output = generate( std::move( workspace ) );
 }
 
@@ -188,6 +215,15 @@ void Compiler::analyze( CompilerWorkspace& workspace, Report& report )
   profile.analyze_micros += timer.ellapsed().count();
 }
 
+void Compiler::remove_unreachable_code( CompilerWorkspace& workspace )
+{
+  if ( !compilercfg.OptimizeDeadCode )
+    return;
+  Pol::Tools::HighPerfTimer timer;
+  UnreachableCodeRemover().remove( workspace );
+  profile.optimize_micros += timer.ellapsed().count();
+}
+
 std::unique_ptr<CompiledScript> Compiler::generate( std::unique_ptr<CompilerWorkspace> workspace )
 {
   Pol::Tools::HighPerfTimer codegen_timer;
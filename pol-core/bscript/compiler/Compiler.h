@@ -29,6 +29,9 @@ public:
   void write_included_filenames( const std::string& pathname );
   void set_include_compile_mode();
 
+  // hash of the file contents and the ecl format version, empty if the file cannot be read
+  static std::string content_hash( const std::string& pathname );
+
   void compile_file_steps( const std::string& pathname, Report& );
   bool format_file( const std::string& filename, bool is_module, bool inplace );
 
@@ -38,6 +41,7 @@ private:
   void optimize( CompilerWorkspace&, Report& );
   void disambiguate( CompilerWorkspace&, Report& );
   void analyze( CompilerWorkspace&, Report& );
+  void remove_unreachable_code( CompilerWorkspace& );
   std::unique_ptr<CompiledScript> generate( std::unique_ptr<CompilerWorkspace> );
 
   void display_outcome( const std::string& filename, Report& );
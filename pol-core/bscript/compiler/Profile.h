@@ -37,6 +37,9 @@ public:
 
   std::atomic<long> cache_hits;
   std::atomic<long> cache_misses;
+
+  std::atomic<long> dependency_hash_hits;
+  std::atomic<long> dependency_hash_misses;
 };
 
 }  // namespace Pol::Bscript::Compiler
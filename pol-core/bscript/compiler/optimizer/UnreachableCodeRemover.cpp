@@ -0,0 +1,94 @@
+#include "UnreachableCodeRemover.h"
+
+#include "bscript/compiler/ast/Block.h"
+#include "bscript/compiler/ast/BooleanValue.h"
+#include "bscript/compiler/ast/ExitStatement.h"
+#include "bscript/compiler/ast/FunctionBody.h"
+#include "bscript/compiler/ast/IntegerValue.h"
+#include "bscript/compiler/ast/JumpStatement.h"
+#include "bscript/compiler/ast/ReturnStatement.h"
+#include "bscript/compiler/ast/Statement.h"
+#include "bscript/compiler/ast/UninitializedValue.h"
+#include "bscript/compiler/ast/WhileLoop.h"
+#include "bscript/compiler/model/CompilerWorkspace.h"
+
+namespace Pol::Bscript::Compiler
+{
+namespace
+{
+// true if the statements following this one can never be executed
+bool leaves_block( Node& statement )
+{
+  if ( dynamic_cast<ReturnStatement*>( &statement ) || dynamic_cast<ExitStatement*>( &statement ) ||
+       dynamic_cast<JumpStatement*>( &statement ) )
+    return true;
+  if ( auto block = dynamic_cast<Block*>( &statement ) )
+    return !block->children.empty() && leaves_block( *block->children.back() );
+  return false;
+}
+}  // namespace
+
+void UnreachableCodeRemover::remove( CompilerWorkspace& workspace )
+{
+  workspace.accept( *this );
+}
+
+void UnreachableCodeRemover::visit_children( Node& node )
+{
+  for ( auto& child : node.children )
+  {
+    child->accept( *this );
+
+    if ( replacement )
+      child = std::move( replacement );
+  }
+}
+
+void UnreachableCodeRemover::visit_block( Block& block )
+{
+  visit_children( block );
+
+  remove_unreachable_statements( block );
+}
+
+void UnreachableCodeRemover::visit_function_body( FunctionBody& function_body )
+{
+  visit_children( function_body );
+
+  remove_unreachable_statements( function_body );
+}
+
+void UnreachableCodeRemover::visit_while_loop( WhileLoop& loop )
+{
+  visit_children( loop );
+
+  auto predicate = &loop.predicate();
+  bool never_entered = false;
+  if ( auto iv = dynamic_cast<IntegerValue*>( predicate ) )
+    never_entered = !iv->value;
+  else if ( auto bv = dynamic_cast<BooleanValue*>( predicate ) )
+    never_entered = !bv->value;
+  else if ( dynamic_cast<UninitializedValue*>( predicate ) )
+    never_entered = true;
+
+  if ( never_entered )
+  {
+    std::vector<std::unique_ptr<Statement>> empty;
+    replacement = std::make_unique<Block>( loop.source_location, std::move( empty ) );
+  }
+}
+
+// Top level statements are left alone, they declare the globals used by functions.
+void UnreachableCodeRemover::remove_unreachable_statements( Node& node )
+{
+  for ( auto itr = node.children.begin(); itr != node.children.end(); ++itr )
+  {
+    if ( leaves_block( **itr ) )
+    {
+      node.children.erase( itr + 1, node.children.end() );
+      break;
+    }
+  }
+}
+
+}  // namespace Pol::Bscript::Compiler
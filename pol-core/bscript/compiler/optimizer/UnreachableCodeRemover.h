@@ -0,0 +1,33 @@
+#ifndef POLSERVER_UNREACHABLECODEREMOVER_H
+#define POLSERVER_UNREACHABLECODEREMOVER_H
+
+#include "bscript/compiler/ast/NodeVisitor.h"
+
+#include <memory>
+
+namespace Pol::Bscript::Compiler
+{
+class CompilerWorkspace;
+
+// Runs after the semantic analysis, so that errors and warnings of statements
+// which can never be executed are still reported.
+class UnreachableCodeRemover : public NodeVisitor
+{
+public:
+  void remove( CompilerWorkspace& );
+
+  void visit_children( Node& ) override;
+
+  void visit_block( Block& ) override;
+  void visit_function_body( FunctionBody& ) override;
+  void visit_while_loop( WhileLoop& ) override;
+
+private:
+  void remove_unreachable_statements( Node& );
+
+  std::unique_ptr<Node> replacement;
+};
+
+}  // namespace Pol::Bscript::Compiler
+
+#endif  // POLSERVER_UNREACHABLECODEREMOVER_H
@@ -56,6 +56,7 @@ void CompilerConfig::Read( const std::string& path )
   WatchModeByDefault = elem.remove_bool( "WatchModeByDefault", false );
   DisplaySummary = elem.remove_bool( "DisplaySummary", false );
   OptimizeObjectMembers = elem.remove_bool( "OptimizeObjectMembers", true );
+  OptimizeDeadCode = elem.remove_bool( "OptimizeDeadCode", true );
   ErrorOnWarning = elem.remove_bool( "ErrorOnWarning", false );
   GenerateDependencyInfo = elem.remove_bool( "GenerateDependencyInfo", OnlyCompileUpdatedScripts );
 
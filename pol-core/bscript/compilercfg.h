@@ -34,6 +34,7 @@ struct CompilerConfig
   bool DisplaySummary;
   bool DisplayUpToDateScripts;
   bool OptimizeObjectMembers;
+  bool OptimizeDeadCode;
   bool ErrorOnWarning;
   bool ThreadedCompilation;
   int NumberOfThreads;
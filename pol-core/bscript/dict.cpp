@@ -9,6 +9,11 @@
 
 #include "dict.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
 #include <stddef.h>
 
 #include "../clib/stlutil.h"
@@ -22,20 +27,287 @@ namespace Pol
 {
 namespace Bscript
 {
-BDictionary::BDictionary() : BObjectImp( OTDictionary ), contents_() {}
+namespace
+{
+u32 mix_hash( u64 x )
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return static_cast<u32>( x );
+}
 
-BDictionary::BDictionary( BObjectType type ) : BObjectImp( type ), contents_() {}
+double number_value( const BObjectImp& imp )
+{
+  if ( imp.isa( BObjectImp::OTLong ) )
+    return static_cast<const BLong&>( imp ).value();
+  return static_cast<const Double&>( imp ).value();
+}
 
-BDictionary::BDictionary( const BDictionary& dict, BObjectType type )
-    : BObjectImp( type ), contents_()
+// equality of two hashable keys, matching the equivalence of their operator<
+bool same_hashed_key( const BObjectImp& a, const BObjectImp& b )
+{
+  if ( a.isa( BObjectImp::OTString ) || b.isa( BObjectImp::OTString ) )
+  {
+    return a.isa( BObjectImp::OTString ) && b.isa( BObjectImp::OTString ) &&
+           static_cast<const String&>( a ).value() == static_cast<const String&>( b ).value();
+  }
+  if ( a.isa( BObjectImp::OTLong ) && b.isa( BObjectImp::OTLong ) )
+    return static_cast<const BLong&>( a ).value() == static_cast<const BLong&>( b ).value();
+  return number_value( a ) == number_value( b );
+}
+}  // namespace
+
+DictionaryContents::DictionaryContents()
+    : entries_(), slots_(), slots_used_( 0 ), other_keys_(), order_(), order_valid_( false )
+{
+}
+
+/**
+ * Strings hash their value, integers and integral reals their integer value (1 and 1.0 are the
+ * same key), other reals their bits. Returns false for keys which have to be stored in the map.
+ */
+bool DictionaryContents::hash_key( const BObject& key, u32& hash )
+{
+  if ( key.isa( BObjectImp::OTString ) )
+  {
+    size_t h = std::hash<std::string>()( key.impptr<String>()->value() );
+    hash = mix_hash( static_cast<u64>( h ) );
+    return true;
+  }
+  if ( key.isa( BObjectImp::OTLong ) )
+  {
+    hash = mix_hash( static_cast<u64>( static_cast<s64>( key.impptr<BLong>()->value() ) ) );
+    return true;
+  }
+  if ( key.isa( BObjectImp::OTDouble ) )
+  {
+    double value = key.impptr<Double>()->value();
+    if ( std::isnan( value ) )
+      return false;
+    if ( std::trunc( value ) == value && std::fabs( value ) < 9.0e18 )
+    {
+      hash = mix_hash( static_cast<u64>( static_cast<s64>( value ) ) );
+    }
+    else
+    {
+      u64 bits;
+      std::memcpy( &bits, &value, sizeof( bits ) );
+      hash = mix_hash( bits );
+    }
+    return true;
+  }
+  return false;
+}
+
+DictionaryContents::const_iterator DictionaryContents::begin() const
+{
+  ensure_order();
+  return const_iterator( this, 0 );
+}
+
+DictionaryContents::const_iterator DictionaryContents::end() const
+{
+  return const_iterator( this, entries_.size() );
+}
+
+size_t DictionaryContents::find_slot( const BObject& key, u32 hash ) const
+{
+  if ( slots_.empty() )
+    return npos;
+  const size_t mask = slots_.size() - 1;
+  for ( size_t i = hash & mask;; i = ( i + 1 ) & mask )
+  {
+    const Slot& slot = slots_[i];
+    if ( slot.entry == 0 )
+      return npos;
+    if ( slot.entry != TOMBSTONE && slot.hash == hash &&
+         same_hashed_key( entries_[slot.entry - 1]->first.impref(), key.impref() ) )
+      return i;
+  }
+}
+
+size_t DictionaryContents::find_entry( const BObject& key ) const
+{
+  u32 hash;
+  if ( hash_key( key, hash ) )
+  {
+    size_t slot = find_slot( key, hash );
+    return slot == npos ? slot : slots_[slot].entry - 1;
+  }
+  auto itr = other_keys_.find( key );
+  return itr == other_keys_.end() ? npos : itr->second;
+}
+
+void DictionaryContents::insert_slot( u32 entry, u32 hash )
+{
+  // at most half of the slots are in use, probing always ends at an empty slot
+  if ( ( slots_used_ + 1 ) * 2 > slots_.size() )
+    grow();
+  const size_t mask = slots_.size() - 1;
+  for ( size_t i = hash & mask;; i = ( i + 1 ) & mask )
+  {
+    Slot& slot = slots_[i];
+    if ( slot.entry == 0 || slot.entry == TOMBSTONE )
+    {
+      if ( slot.entry == 0 )
+        ++slots_used_;
+      slot.entry = entry + 1;
+      slot.hash = hash;
+      return;
+    }
+  }
+}
+
+void DictionaryContents::grow()
 {
-  for ( const auto& elem : dict.contents_ )
+  size_t live = 0;
+  for ( const auto& slot : slots_ )
+  {
+    if ( slot.entry != 0 && slot.entry != TOMBSTONE )
+      ++live;
+  }
+  size_t capacity = 8;
+  while ( capacity < ( live + 1 ) * 4 )
+    capacity *= 2;
+  std::vector<Slot> old( capacity, Slot{ 0, 0 } );
+  old.swap( slots_ );
+  slots_used_ = live;
+  const size_t mask = capacity - 1;
+  for ( const auto& slot : old )
   {
-    const BObject& bkeyobj = elem.first;
-    const BObjectRef& bvalref = elem.second;
+    if ( slot.entry == 0 || slot.entry == TOMBSTONE )
+      continue;
+    size_t i = slot.hash & mask;
+    while ( slots_[i].entry != 0 )
+      i = ( i + 1 ) & mask;
+    slots_[i] = slot;
+  }
+}
+
+void DictionaryContents::ensure_order() const
+{
+  if ( order_valid_ )
+    return;
+  order_.resize( entries_.size() );
+  std::iota( order_.begin(), order_.end(), 0 );
+  std::sort( order_.begin(), order_.end(),
+             [this]( u32 a, u32 b ) { return entries_[a]->first < entries_[b]->first; } );
+  order_valid_ = true;
+}
 
-    contents_[bkeyobj] = BObjectRef( new BObject( bvalref->impref().copy() ) );
+size_t DictionaryContents::order_position( u32 entry ) const
+{
+  const BObject& key = entries_[entry]->first;
+  auto itr = std::lower_bound( order_.begin(), order_.end(), key,
+                               [this]( u32 a, const BObject& k ) { return entries_[a]->first < k; } );
+  return itr - order_.begin();
+}
+
+BObjectRef* DictionaryContents::find( const BObject& key )
+{
+  size_t index = find_entry( key );
+  if ( index == npos )
+    return nullptr;
+  return &entries_[index]->second;
+}
+
+size_t DictionaryContents::count( const BObject& key ) const
+{
+  return find_entry( key ) == npos ? 0 : 1;
+}
+
+BObjectRef& DictionaryContents::operator[]( const BObject& key )
+{
+  size_t index = find_entry( key );
+  if ( index != npos )
+    return entries_[index]->second;
+
+  u32 entry = static_cast<u32>( entries_.size() );
+  entries_.emplace_back( std::in_place, key, BObjectRef() );
+  u32 hash;
+  if ( hash_key( key, hash ) )
+    insert_slot( entry, hash );
+  else
+    other_keys_.emplace( key, entry );
+  if ( order_valid_ )
+  {
+    // the new entry is the last one in order_, until it got sorted in
+    order_.push_back( entry );
+    auto itr = std::lower_bound( order_.begin(), order_.end() - 1, key,
+                                 [this]( u32 a, const BObject& k )
+                                 { return entries_[a]->first < k; } );
+    std::rotate( itr, order_.end() - 1, order_.end() );
   }
+  return entries_.back()->second;
+}
+
+size_t DictionaryContents::erase( const BObject& key )
+{
+  size_t index = find_entry( key );
+  if ( index == npos )
+    return 0;
+
+  u32 hash;
+  const BObject& erased = entries_[index]->first;
+  if ( hash_key( erased, hash ) )
+    slots_[find_slot( erased, hash )].entry = TOMBSTONE;
+  else
+    other_keys_.erase( erased );
+  if ( order_valid_ )
+    order_.erase( order_.begin() + order_position( static_cast<u32>( index ) ) );
+
+  size_t last = entries_.size() - 1;
+  if ( index != last )
+  {
+    const BObject& moved = entries_[last]->first;
+    if ( hash_key( moved, hash ) )
+      slots_[find_slot( moved, hash )].entry = static_cast<u32>( index + 1 );
+    else
+      other_keys_.find( moved )->second = static_cast<u32>( index );
+    if ( order_valid_ )
+      order_[order_position( static_cast<u32>( last ) )] = static_cast<u32>( index );
+    entries_[index].emplace( *entries_[last] );
+  }
+  entries_.pop_back();
+  return 1;
+}
+
+const DictionaryContents::value_type* DictionaryContents::next( const BObject& key ) const
+{
+  size_t index = find_entry( key );
+  if ( index == npos )
+    return nullptr;
+  ensure_order();
+  size_t pos = order_position( static_cast<u32>( index ) ) + 1;
+  if ( pos >= order_.size() )
+    return nullptr;
+  return &*entries_[order_[pos]];
+}
+
+size_t DictionaryContents::sizeEstimate() const
+{
+  return Clib::memsize( entries_,
+                        []( const auto& v )
+                        {
+                          return sizeof( v ) + v->first.sizeEstimate() +
+                                 v->second.sizeEstimate();
+                        } ) +
+         Clib::memsize( slots_ ) + Clib::memsize( other_keys_ ) + Clib::memsize( order_ );
+}
+
+BDictionary::BDictionary() : BObjectImp( OTDictionary ), contents_() {}
+
+BDictionary::BDictionary( BObjectType type ) : BObjectImp( type ), contents_() {}
+
+BDictionary::BDictionary( const BDictionary& dict, BObjectType type )
+    : BObjectImp( type ), contents_( dict.contents_ )
+{
+  // keys are shared like before, values get copied
+  for ( auto& entry : contents_.entries_ )
+    entry->second.set( new BObject( entry->second->impref().copy() ) );
 }
 
 BDictionary::BDictionary( std::istream& is, unsigned size, BObjectType type )
@@ -85,6 +357,7 @@ BDictionaryIterator::BDictionaryIterator( BDictionary* pDict, BObject* pIterVal
 
 BObject* BDictionaryIterator::step()
 {
+  const DictionaryContents::value_type* entry;
   if ( m_First )
   {
     auto itr = m_pDict->contents_.begin();
@@ -92,29 +365,19 @@ BObject* BDictionaryIterator::step()
       return nullptr;
 
     m_First = false;
-    const BObject& okey = ( *itr ).first;
-    m_Key.setimp( okey.impptr()->copy() );
-    m_IterVal->setimp( m_Key.impptr() );
-
-    BObjectRef& oref = ( *itr ).second;
-    return oref.get();
+    entry = &*itr;
   }
   else
   {
-    auto itr = m_pDict->contents_.find( m_Key );
-    if ( itr == m_pDict->contents_.end() )
-      return nullptr;
-    ++itr;
-    if ( itr == m_pDict->contents_.end() )
+    entry = m_pDict->contents_.next( m_Key );
+    if ( entry == nullptr )
       return nullptr;
-
-    const BObject& okey = ( *itr ).first;
-    m_Key.setimp( okey.impptr()->copy() );
-    m_IterVal->setimp( m_Key.impptr() );
-
-    BObjectRef& oref = ( *itr ).second;
-    return oref.get();
   }
+  const BObject& okey = entry->first;
+  m_Key.setimp( okey.impptr()->copy() );
+  m_IterVal->setimp( m_Key.impptr() );
+
+  return entry->second.get();
 }
 
 ContIterator* BDictionary::createIterator( BObject* pIterVal )
@@ -129,8 +392,7 @@ BObjectImp* BDictionary::copy() const
 
 size_t BDictionary::sizeEstimate() const
 {
-  return sizeof( BDictionary ) +
-         Clib::memsize_keyvalue( contents_, []( const auto& v ) { return v.sizeEstimate(); } );
+  return sizeof( BDictionary ) + contents_.sizeEstimate();
 }
 
 size_t BDictionary::mapcount() const
@@ -143,12 +405,10 @@ BObjectRef BDictionary::set_member( const char* membername, BObjectImp* value, b
   BObject key( new String( membername ) );
   BObjectImp* target = copy ? value->copy() : value;
 
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  if ( BObjectRef* oref = contents_.find( key ) )
   {
-    BObjectRef& oref = ( *itr ).second;
-    oref->setimp( target );
-    return oref;
+    ( *oref )->setimp( target );
+    return *oref;
   }
   else
   {
@@ -162,10 +422,9 @@ BObjectRef BDictionary::get_member( const char* membername )
 {
   BObject key( new String( membername ) );
 
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  if ( BObjectRef* oref = contents_.find( key ) )
   {
-    return ( *itr ).second;
+    return *oref;
   }
   else
   {
@@ -179,11 +438,9 @@ BObjectRef BDictionary::OperSubscript( const BObject& obj )
   if ( obj->isa( OTString ) || obj->isa( OTLong ) || obj->isa( OTDouble ) ||
        obj->isa( OTApplicObj ) )
   {
-    auto itr = contents_.find( obj );
-    if ( itr != contents_.end() )
+    if ( BObjectRef* oref = contents_.find( obj ) )
     {
-      BObjectRef& oref = ( *itr ).second;
-      return oref;
+      return *oref;
     }
     else
     {
@@ -204,11 +461,9 @@ BObjectImp* BDictionary::array_assign( BObjectImp* idx, BObjectImp* target, bool
     BObjectImp* new_target = copy ? target->copy() : target;
 
     BObject obj( idx );
-    auto itr = contents_.find( obj );
-    if ( itr != contents_.end() )
+    if ( BObjectRef* oref = contents_.find( obj ) )
     {
-      BObjectRef& oref = ( *itr ).second;
-      oref->setimp( new_target );
+      ( *oref )->setimp( new_target );
       return new_target;
     }
     else
@@ -275,7 +530,7 @@ BObjectImp* BDictionary::call_method_id( const int id, Executor& ex, bool /*forc
               keyobj->isa( OTApplicObj ) ) )
         return new BError( "Dictionary keys must be integer, real, or string" );
       BObject key( keyobj->impptr()->copy() );
-      contents_[key] = BObjectRef( new BObject( valobj->impptr()->copy() ) );
+      contents_[key] = BObjectRef( new BObject( ex.takeParamImp( 1 ) ) );
       return new BLong( static_cast<int>( contents_.size() ) );
     }
     else
@@ -13,8 +13,12 @@
 #endif
 
 #include <iosfwd>
+#include <iterator>
 #include <map>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "../clib/rawtypes.h"
 
@@ -31,6 +35,99 @@ namespace Pol
 {
 namespace Bscript
 {
+/**
+ * Storage of a dictionary.
+ *
+ * String and number keys are found by an open addressing hash index, all other key types (which
+ * compare by their own operator<) by a map. Iteration is in key order like a std::map, the sorted
+ * order gets built on first use and is kept up to date afterwards.
+ */
+class DictionaryContents
+{
+public:
+  typedef std::pair<BObject, BObjectRef> value_type;
+
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef DictionaryContents::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    const_iterator() : contents_( nullptr ), pos_( 0 ) {}
+    const_iterator( const DictionaryContents* contents, size_t pos )
+        : contents_( contents ), pos_( pos )
+    {
+    }
+    reference operator*() const { return *contents_->entries_[contents_->order_[pos_]]; }
+    pointer operator->() const { return &**this; }
+    const_iterator& operator++()
+    {
+      ++pos_;
+      return *this;
+    }
+    const_iterator operator++( int )
+    {
+      const_iterator tmp = *this;
+      ++pos_;
+      return tmp;
+    }
+    bool operator==( const const_iterator& other ) const { return pos_ == other.pos_; }
+    bool operator!=( const const_iterator& other ) const { return pos_ != other.pos_; }
+
+  private:
+    const DictionaryContents* contents_;
+    size_t pos_;
+  };
+
+  DictionaryContents();
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  // sorted by key
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  BObjectRef* find( const BObject& key );
+  size_t count( const BObject& key ) const;
+  // value of key, a new empty BObjectRef is inserted if missing
+  BObjectRef& operator[]( const BObject& key );
+  size_t erase( const BObject& key );
+  // entry following key in key order, nullptr if key is missing or the last one
+  const value_type* next( const BObject& key ) const;
+
+  size_t sizeEstimate() const;
+
+private:
+  struct Slot
+  {
+    u32 entry;  // index into entries_ + 1, 0 empty, TOMBSTONE erased
+    u32 hash;
+  };
+  static constexpr u32 TOMBSTONE = ~0u;
+  static constexpr size_t npos = ~static_cast<size_t>( 0 );
+  static bool hash_key( const BObject& key, u32& hash );
+
+  size_t find_entry( const BObject& key ) const;
+  size_t find_slot( const BObject& key, u32 hash ) const;
+  void insert_slot( u32 entry, u32 hash );
+  void grow();
+  void ensure_order() const;
+  size_t order_position( u32 entry ) const;
+
+  friend class BDictionary;
+
+  // unordered, erasing moves the last entry into the gap (BObject is not assignable)
+  std::vector<std::optional<value_type>> entries_;
+  std::vector<Slot> slots_;
+  size_t slots_used_;  // including tombstones
+  std::map<BObject, u32> other_keys_;
+  mutable std::vector<u32> order_;
+  mutable bool order_valid_;
+};
+
 class BDictionary final : public BObjectImp
 {
 public:
@@ -43,7 +140,7 @@ public:
   void addMember( BObjectImp* key, BObjectImp* val );
   size_t mapcount() const;
 
-  typedef std::map<BObject, BObjectRef> Contents;
+  typedef DictionaryContents Contents;
   const Contents& contents() const;
 
 protected:
@@ -11,6 +11,7 @@
 #include "../clib/stlutil.h"
 #include "escriptv.h"
 #include "fmodule.h"
+#include "scriptprofile.h"
 
 namespace Pol
 {
@@ -34,6 +35,7 @@ EScriptProgram::EScriptProgram()
       version( 0 ),
       invocations( 0 ),
       instr_cycles( 0 ),
+      profile(),
       pkg( nullptr ),
       instr(),
       debug_loaded( false ),
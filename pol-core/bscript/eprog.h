@@ -8,7 +8,9 @@
 #ifndef BSCRIPT_EPROG_H
 #define BSCRIPT_EPROG_H
 
+#include <atomic>
 #include <iosfwd>
+#include <memory>
 #include <stdio.h>
 #include <string>
 #include <vector>
@@ -30,15 +32,50 @@ namespace Bscript
 {
 class CompilerContext;
 class FunctionalityModule;
+class ScriptProfile;
+
+/**
+ * Monomorphic inline cache of a member access instruction: shape id and member index of the
+ * struct the instruction saw last. Shape id 0 is never cached.
+ */
+class MemberCache
+{
+public:
+  MemberCache() : value_( 0 ) {}
+  MemberCache( const MemberCache& ) : value_( 0 ) {}
+  MemberCache& operator=( const MemberCache& )
+  {
+    value_.store( 0, std::memory_order_relaxed );
+    return *this;
+  }
+  bool lookup( u32 shape_id, size_t& index ) const
+  {
+    u64 value = value_.load( std::memory_order_relaxed );
+    if ( shape_id == 0 || static_cast<u32>( value >> 32 ) != shape_id )
+      return false;
+    index = static_cast<u32>( value );
+    return true;
+  }
+  void remember( u32 shape_id, size_t index )
+  {
+    // shape and index in one word, executors of the same program may run in different threads
+    value_.store( ( static_cast<u64>( shape_id ) << 32 ) | static_cast<u32>( index ),
+                  std::memory_order_relaxed );
+  }
+
+private:
+  std::atomic<u64> value_;
+};
 
 class Instruction
 {
 public:
-  Instruction( ExecInstrFunc f ) : token(), func( f ), cycles( 0 ) {}
-  Instruction() : token(), func( 0 ), cycles( 0 ) {}
+  Instruction( ExecInstrFunc f ) : token(), func( f ), cycles( 0 ), member_cache() {}
+  Instruction() : token(), func( 0 ), cycles( 0 ), member_cache() {}
   Token token;
   ExecInstrFunc func;
   mutable unsigned int cycles;
+  mutable MemberCache member_cache;
 };
 
 struct EPDbgInstr
@@ -151,6 +188,7 @@ public:
   unsigned short version;
   unsigned int invocations;
   u64 instr_cycles;  // FIXME need an enable-profiling flag
+  std::unique_ptr<ScriptProfile> profile;  // created by the first sample
   Plib::Package const* pkg;
   std::vector<Instruction> instr;
 
@@ -16,6 +16,7 @@
 #include "compctx.h"
 // EPROG compiler-only functions
 #include "eprog.h"
+#include "scriptprofile.h"
 #include "filefmt.h"
 #include "fmodule.h"
 #include "symcont.h"
@@ -591,6 +592,8 @@ size_t EScriptProgram::sizeEstimate() const
   size += memsize( dbg_filenum ) + memsize( dbg_linenum ) + memsize( dbg_ins_blocks ) +
           memsize( dbg_ins_statementbegin ) + memsize( modules ) + memsize( exported_functions ) +
           memsize( instr ) + memsize( blocks ) + memsize( dbg_functions );
+  if ( profile )
+    size += profile->sizeEstimate();
 
   return size;
 }
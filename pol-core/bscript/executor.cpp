@@ -21,6 +21,7 @@
 #include "../clib/stlutil.h"
 #include "../clib/strutil.h"
 #include "berror.h"
+#include "bstruct.h"
 #include "config.h"
 #include "continueimp.h"
 #include "contiter.h"
@@ -31,6 +32,7 @@
 #include "fmodule.h"
 #include "impstr.h"
 #include "objmethods.h"
+#include "scriptprofile.h"
 #include "str.h"
 #include "token.h"
 #include "tokens.h"
@@ -39,6 +41,7 @@
 #include "../clib/mlog.h"
 #endif
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -186,6 +189,49 @@ bool ExecutorDebugEnvironment::on_instruction( Executor& ex )
 
 extern int executor_count;
 Clib::SpinLock Executor::_executor_lock;
+
+namespace
+{
+// stacks of finished executors with their grown capacity, handed to new executors so short
+// lived scripts don't reallocate them while they grow (guarded by Executor::_executor_lock)
+struct RecycledStacks
+{
+  ValueStackCont value_stack;
+  std::vector<ReturnContext> control_stack;
+  std::vector<BObjectRef> fparams;
+  std::vector<std::unique_ptr<BObjectRefVec>> spare_locals;
+};
+struct RecycledStacksPool
+{
+  ~RecycledStacksPool();
+  std::vector<RecycledStacks> stacks;
+};
+RecycledStacksPool recycled_stacks;
+// executors destroyed during static destruction must not touch the pool anymore
+bool recycled_stacks_closed = false;
+RecycledStacksPool::~RecycledStacksPool()
+{
+  recycled_stacks_closed = true;
+}
+const size_t MAX_RECYCLED_STACKS = 64;
+const size_t MAX_SPARE_LOCALS = 32;
+// larger containers are freed instead of being kept around
+const size_t MAX_RECYCLED_CAPACITY = 1024;
+
+bool is_number( const BObjectImp& imp )
+{
+  return imp.isa( BObjectImp::OTLong ) || imp.isa( BObjectImp::OTDouble );
+}
+
+// a number only referenced by the value stack can take the result of arithmetic with another
+// number, the in place operators (as used by +=) give the same result without allocating new
+// objects
+bool takes_result( const BObject& left, const BObject& right )
+{
+  return left.count() == 1 && left.impref().count() == 1 && is_number( left.impref() ) &&
+         is_number( right.impref() );
+}
+}  // namespace
 Executor::Executor()
     : done( 0 ),
       error_( false ),
@@ -194,14 +240,15 @@ Executor::Executor()
       debug_level( NONE ),
       PC( 0 ),
       Globals2( std::make_shared<BObjectRefVec>() ),
-      Locals2( new BObjectRefVec ),
+      Locals2( nullptr ),
       nLines( 0 ),
       current_module_function( nullptr ),
       prog_ok_( false ),
       viewmode_( false ),
       runs_to_completion_( false ),
       dbg_env_( nullptr ),
-      func_result_( nullptr )
+      func_result_( nullptr ),
+      instr_since_sample_( 0 )
 {
   Clib::SpinLockGuard lock( _executor_lock );
   ++executor_count;
@@ -212,6 +259,16 @@ Executor::Executor()
     UninitObject::SharedInstance = new UninitObject;
     UninitObject::SharedInstanceOwner.set( UninitObject::SharedInstance );
   }
+  if ( !recycled_stacks_closed && !recycled_stacks.stacks.empty() )
+  {
+    RecycledStacks& stacks = recycled_stacks.stacks.back();
+    ValueStack.swap( stacks.value_stack );
+    ControlStack.swap( stacks.control_stack );
+    fparams.swap( stacks.fparams );
+    spare_locals_.swap( stacks.spare_locals );
+    recycled_stacks.stacks.pop_back();
+  }
+  Locals2 = acquireLocals();
 }
 
 Executor::~Executor()
@@ -222,6 +279,7 @@ Executor::~Executor()
     executor_instances.erase( this );
   }
   cleanup();
+  recycleStacks();
 }
 void Executor::cleanup()
 {
@@ -231,12 +289,12 @@ void Executor::cleanup()
       listener->on_destroy();
   }
 
-  delete Locals2;
+  releaseLocals( Locals2 );
   Locals2 = nullptr;
 
   while ( !upperLocals2.empty() )
   {
-    delete upperLocals2.back();
+    releaseLocals( upperLocals2.back() );
     upperLocals2.pop_back();
   }
 
@@ -244,6 +302,50 @@ void Executor::cleanup()
   Clib::delete_all( availmodules );
 }
 
+void Executor::recycleStacks()
+{
+  // the values are released outside of the lock, they may be arbitrary objects
+  ValueStack.clear();
+  ControlStack.clear();
+  fparams.clear();
+  if ( ValueStack.capacity() > MAX_RECYCLED_CAPACITY ||
+       ControlStack.capacity() > MAX_RECYCLED_CAPACITY ||
+       fparams.capacity() > MAX_RECYCLED_CAPACITY )
+    return;
+
+  Clib::SpinLockGuard lock( _executor_lock );
+  if ( recycled_stacks_closed || recycled_stacks.stacks.size() >= MAX_RECYCLED_STACKS )
+    return;
+  recycled_stacks.stacks.emplace_back();
+  RecycledStacks& stacks = recycled_stacks.stacks.back();
+  stacks.value_stack.swap( ValueStack );
+  stacks.control_stack.swap( ControlStack );
+  stacks.fparams.swap( fparams );
+  stacks.spare_locals.swap( spare_locals_ );
+}
+
+BObjectRefVec* Executor::acquireLocals()
+{
+  if ( spare_locals_.empty() )
+    return new BObjectRefVec;
+  BObjectRefVec* locals = spare_locals_.back().release();
+  spare_locals_.pop_back();
+  return locals;
+}
+
+void Executor::releaseLocals( BObjectRefVec* locals )
+{
+  if ( locals == nullptr )
+    return;
+  if ( spare_locals_.size() >= MAX_SPARE_LOCALS || locals->capacity() > MAX_RECYCLED_CAPACITY )
+  {
+    delete locals;
+    return;
+  }
+  locals->clear();
+  spare_locals_.emplace_back( locals );
+}
+
 bool Executor::AttachFunctionalityModules()
 {
   for ( auto& fm : prog_->modules )
@@ -421,6 +523,25 @@ BObjectImp* Executor::getParamImp( unsigned param )
   return fparams[param].get()->impptr();
 }
 
+BObjectImp* Executor::takeParamImp( unsigned param )
+{
+  passert_r( param < fparams.size(), "Script Error in '" + scriptname() +
+                                         ": Less Parameter than expected. " +
+                                         "You should use *.em-files shipped with this Core and "
+                                         "recompile ALL of your Scripts _now_! RTFM" );
+
+  return takeImp( *fparams[param] );
+}
+
+BObjectImp* Executor::takeImp( BObject& obj )
+{
+  // nothing else can see a value referenced only by this object, so it can be handed over
+  // instead of being (deep) copied
+  if ( obj.count() == 1 && obj.impref().count() == 1 )
+    return obj.impptr();
+  return obj.impptr()->copy();
+}
+
 BObject* Executor::getParamObj( unsigned param )
 {
   if ( fparams.size() > param )
@@ -1109,7 +1230,7 @@ void Executor::popParam( const Token& /*token*/ )
   BObjectRef objref = getObjRef();
 
   Locals2->push_back( BObjectRef() );
-  Locals2->back().set( new BObject( objref->impptr()->copy() ) );
+  Locals2->back().set( new BObject( takeImp( *objref ) ) );
 }
 
 void Executor::popParamByRef( const Token& /*token*/ )
@@ -1130,7 +1251,7 @@ void Executor::getArg( const Token& /*token*/ )
   {
     BObjectRef objref = getObjRef();
     Locals2->push_back( BObjectRef() );
-    Locals2->back().set( new BObject( objref->impptr()->copy() ) );
+    Locals2->back().set( new BObject( takeImp( *objref ) ) );
   }
 }
 
@@ -1659,8 +1780,12 @@ void Executor::ins_set_member( const Instruction& ins )
   BObject& left = *leftref;
 
   BObjectImp& rightimpref = right.impref();
-  left.impref().set_member( ins.token.tokval(), &rightimpref,
-                            !( right.count() == 1 && rightimpref.count() == 1 ) );
+  bool copy = !( right.count() == 1 && rightimpref.count() == 1 );
+  if ( left.isa( BObjectImp::OTStruct ) || left.isa( BObjectImp::OTError ) )
+    left.impptr<BStruct>()->set_member_cached( ins.token.tokval(), &rightimpref, copy,
+                                               ins.member_cache );
+  else
+    left.impref().set_member( ins.token.tokval(), &rightimpref, copy );
 }
 
 void Executor::ins_set_member_id( const Instruction& ins )
@@ -1687,8 +1812,12 @@ void Executor::ins_set_member_consume( const Instruction& ins )
   BObject& left = *leftref;
 
   BObjectImp& rightimpref = right.impref();
-  left.impref().set_member( ins.token.tokval(), &rightimpref,
-                            !( right.count() == 1 && rightimpref.count() == 1 ) );
+  bool copy = !( right.count() == 1 && rightimpref.count() == 1 );
+  if ( left.isa( BObjectImp::OTStruct ) || left.isa( BObjectImp::OTError ) )
+    left.impptr<BStruct>()->set_member_cached( ins.token.tokval(), &rightimpref, copy,
+                                               ins.member_cache );
+  else
+    left.impref().set_member( ins.token.tokval(), &rightimpref, copy );
   ValueStack.pop_back();
 }
 
@@ -1832,7 +1961,10 @@ void Executor::ins_get_member( const Instruction& ins )
   std::string name( strm.str() );
   unsigned long profile_start = GetTimeUs();
 #endif
-  leftref = left->get_member( ins.token.tokval() );
+  if ( left.isa( BObjectImp::OTStruct ) || left.isa( BObjectImp::OTError ) )
+    leftref = left.impptr<BStruct>()->get_member_cached( ins.token.tokval(), ins.member_cache );
+  else
+    leftref = left->get_member( ins.token.tokval() );
 #ifdef ESCRIPT_PROFILE
   profile_escript( name, profile_start );
 #endif
@@ -2019,7 +2151,10 @@ void Executor::ins_add( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  leftref.set( new BObject( right.impref().selfPlusObjImp( left.impref() ) ) );
+  if ( takes_result( left, right ) )
+    left.impref().operPlusEqual( left, right.impref() );
+  else
+    leftref.set( new BObject( right.impref().selfPlusObjImp( left.impref() ) ) );
 }
 
 // TOK_SUBTRACT
@@ -2037,7 +2172,10 @@ void Executor::ins_subtract( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  leftref.set( new BObject( right.impref().selfMinusObjImp( left.impref() ) ) );
+  if ( takes_result( left, right ) )
+    left.impref().operMinusEqual( left, right.impref() );
+  else
+    leftref.set( new BObject( right.impref().selfMinusObjImp( left.impref() ) ) );
 }
 
 // TOK_MULT:
@@ -2055,7 +2193,10 @@ void Executor::ins_mult( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  leftref.set( new BObject( right.impref().selfTimesObjImp( left.impref() ) ) );
+  if ( takes_result( left, right ) )
+    left.impref().operTimesEqual( left, right.impref() );
+  else
+    leftref.set( new BObject( right.impref().selfTimesObjImp( left.impref() ) ) );
 }
 // TOK_DIV:
 void Executor::ins_div( const Instruction& /*ins*/ )
@@ -2072,7 +2213,10 @@ void Executor::ins_div( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  leftref.set( new BObject( right.impref().selfDividedByObjImp( left.impref() ) ) );
+  if ( takes_result( left, right ) )
+    left.impref().operDivideEqual( left, right.impref() );
+  else
+    leftref.set( new BObject( right.impref().selfDividedByObjImp( left.impref() ) ) );
 }
 // TOK_MODULUS:
 void Executor::ins_modulus( const Instruction& /*ins*/ )
@@ -2089,7 +2233,11 @@ void Executor::ins_modulus( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  leftref.set( new BObject( right.impref().selfModulusObjImp( left.impref() ) ) );
+  // there is no in place modulus by a real
+  if ( right.isa( BObjectImp::OTLong ) && takes_result( left, right ) )
+    left.impref().operModulusEqual( left, right.impref() );
+  else
+    leftref.set( new BObject( right.impref().selfModulusObjImp( left.impref() ) ) );
 }
 // TOK_BSRIGHT:
 void Executor::ins_bitshift_right( const Instruction& /*ins*/ )
@@ -2526,6 +2674,11 @@ void Executor::ins_insert_into( const Instruction& /*ins*/ )
       next = pIter->step();
     }
   }
+  else if ( left.isa( BObjectImp::OTArray ) && right.count() == 1 && right.impref().count() == 1 )
+  {
+    // a temporary (e.g. a function result in an array literal) can be moved into the array
+    left.impref<ObjArray>().addElement( right.impptr() );
+  }
   else
   {
     left.impref().operInsertInto( left, right.impref() );
@@ -2815,7 +2968,7 @@ void Executor::ins_makelocal( const Instruction& /*ins*/ )
 {
   if ( Locals2 )
     upperLocals2.push_back( Locals2 );
-  Locals2 = new BObjectRefVec;
+  Locals2 = acquireLocals();
 }
 
 // CTRL_JSR_USERFUNC:
@@ -2920,7 +3073,7 @@ void Executor::ins_gosub( const Instruction& ins )
   ControlStack.push_back( rc );
   if ( Locals2 )
     upperLocals2.push_back( Locals2 );
-  Locals2 = new BObjectRefVec;
+  Locals2 = acquireLocals();
 
   PC = (unsigned)ins.token.lval;
 }
@@ -2946,7 +3099,7 @@ void Executor::ins_return( const Instruction& /*ins*/ )
 
   if ( Locals2 )
   {
-    delete Locals2;
+    releaseLocals( Locals2 );
     Locals2 = nullptr;
   }
   if ( !upperLocals2.empty() )
@@ -3490,7 +3643,12 @@ void Executor::execInstr()
 
     ++PC;
 
-    ( this->*( ins.func ) )( ins );
+    const unsigned sample_interval =
+        ScriptProfile::sample_interval.load( std::memory_order_relaxed );
+    if ( sample_interval && ++instr_since_sample_ >= sample_interval )
+      execSampledInstr( ins, onPC, sample_interval );
+    else
+      ( this->*( ins.func ) )( ins );
   }
   catch ( std::exception& ex )
   {
@@ -3521,6 +3679,31 @@ void Executor::execInstr()
 #endif
 }
 
+void Executor::execSampledInstr( const Instruction& ins, unsigned onPC, unsigned sample_interval )
+{
+  instr_since_sample_ = 0;
+  // call sites of the active user functions of this program, outermost first
+  std::vector<unsigned> stack;
+  stack.reserve( ControlStack.size() + 1 );
+  for ( const auto& ctx : ControlStack )
+  {
+    if ( ctx.ExternalContext )
+      stack.clear();  // the frames below belong to the calling program
+    else
+      stack.push_back( ctx.PC - 1 );
+  }
+  stack.push_back( onPC );
+  // an instruction may switch to another program, keep the sampled one alive
+  ref_ptr<EScriptProgram> prog( prog_ );
+
+  auto start = std::chrono::steady_clock::now();
+  ( this->*( ins.func ) )( ins );
+  u64 elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start )
+                    .count();
+  ScriptProfile::add_sample( *prog, std::move( stack ), elapsed * sample_interval );
+}
+
 std::string Executor::dbg_get_instruction( size_t atPC ) const
 {
   std::string out;
@@ -3643,8 +3826,8 @@ void Executor::reinitExec()
   seterror( false );
 
   ValueStack.clear();
-  delete Locals2;
-  Locals2 = new BObjectRefVec;
+  releaseLocals( Locals2 );
+  Locals2 = acquireLocals();
 
   if ( !prog_ok_ )
   {
@@ -3703,6 +3886,11 @@ void Executor::addModule( ExecutorModule* module )
   availmodules.push_back( module );
 }
 
+void Executor::addModule( const char* name, ExecutorModuleFactory factory )
+{
+  lazymodules.emplace_back( name, factory );
+}
+
 
 ExecutorModule* Executor::findModule( const std::string& name )
 {
@@ -3713,6 +3901,16 @@ ExecutorModule* Executor::findModule( const std::string& name )
     if ( stricmp( module->moduleName.get().c_str(), name.c_str() ) == 0 )
       return module;
   }
+  for ( auto itr = lazymodules.begin(); itr != lazymodules.end(); ++itr )
+  {
+    if ( stricmp( itr->first, name.c_str() ) == 0 )
+    {
+      ExecutorModule* module = itr->second( *this );
+      lazymodules.erase( itr );
+      addModule( module );
+      return module;
+    }
+  }
   return nullptr;
 }
 
@@ -3855,6 +4053,9 @@ size_t Executor::sizeEstimate() const
     }
   }
   size += Clib::memsize( ControlStack );
+  size += Clib::memsize( spare_locals_ );
+  for ( const auto& locals : spare_locals_ )
+    size += Clib::memsize( *locals );
 
   size += Clib::memsize( *Locals2 );
   for ( const auto& bojectref : *Locals2 )
@@ -3885,7 +4086,8 @@ size_t Executor::sizeEstimate() const
     if ( module != nullptr )
       size += module->sizeEstimate();
   }
-  size += Clib::memsize( execmodules ) + Clib::memsize( availmodules );
+  size += Clib::memsize( execmodules ) + Clib::memsize( availmodules ) +
+          Clib::memsize( lazymodules );
   size += dbg_env_ != nullptr ? dbg_env_->sizeEstimate() : 0;
   size += func_result_ != nullptr ? func_result_->sizeEstimate() : 0;
   return size;
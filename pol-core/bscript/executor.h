@@ -24,6 +24,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../clib/refptr.h"
@@ -56,6 +57,8 @@ class ExecutorModule;
 class ModuleFunction;
 class String;
 class Token;
+
+typedef ExecutorModule* ( *ExecutorModuleFactory )( Executor& );
 #ifdef ESCRIPT_PROFILE
 
 struct profile_instr
@@ -186,6 +189,9 @@ public:
   std::vector<ReturnContext> ControlStack;
 
   BObjectRefVec* Locals2;
+  // a new local variable frame, reusing the storage of returned ones
+  BObjectRefVec* acquireLocals();
+  void releaseLocals( BObjectRefVec* locals );
 
   static UninitObject* m_SharedUninitObject;
 
@@ -246,6 +252,8 @@ public:
   BObjectImp* getParamImp( unsigned param, BObjectImp::BObjectType type );
   BObjectImp* getParamImp2( unsigned param, BObjectImp::BObjectType type );
   BObject* getParamObj( unsigned param );
+  // the parameter value for storing it somewhere, copied only if it is referenced elsewhere
+  BObjectImp* takeParamImp( unsigned param );
 
   const String* getStringParam( unsigned param );
   const BLong* getLongParam( unsigned param );
@@ -310,6 +318,8 @@ public:
   // availmodules.
   std::vector<ExecutorModule*> execmodules;
   std::vector<ExecutorModule*> availmodules;  // owns
+  // modules which are created by findModule on first use and then moved to availmodules
+  std::vector<std::pair<const char*, ExecutorModuleFactory>> lazymodules;
 
 public:
   Executor();
@@ -318,6 +328,8 @@ public:
   Executor& operator=( const Executor& exec ) = delete;
 
   void addModule( ExecutorModule* module );  // NOTE, executor deletes its modules when done
+  // the module is only created when the program uses one of its functions or it is looked up
+  void addModule( const char* name, ExecutorModuleFactory factory );
   ExecutorModule* findModule( const std::string& name );
 
   ModuleFunction* current_module_function;
@@ -513,8 +525,15 @@ private:
   std::unique_ptr<ExecutorDebugEnvironment> dbg_env_;
 
   BObjectImp* func_result_;
+  unsigned instr_since_sample_;
 
+  void execSampledInstr( const Instruction& ins, unsigned onPC, unsigned sample_interval );
   void printStack( const std::string& message );
+  static BObjectImp* takeImp( BObject& obj );
+  void recycleStacks();
+
+  // cleared frames of returned functions
+  std::vector<std::unique_ptr<BObjectRefVec>> spare_locals_;
 
 private:
 #ifdef ESCRIPT_PROFILE
@@ -10,9 +10,11 @@
 #include "bobject.h"
 #endif
 
+#include <memory>
 #include <stack>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace Pol
 {
@@ -30,13 +32,16 @@ public:
     YES,  // performs unicode sanitize should be done for every external value (assuming ISO8859)
     NO    // performs no unicode sanitize should only be used for internal usage
   };
-  String() : BObjectImp( OTString ), value_( "" ) {}
+  String() : BObjectImp( OTString ), value_( "" ), codepoints_( 0 ), index_() {}
   explicit String( const char* str, size_t nchars, Tainted san = Tainted::NO );
   explicit String( const char* str, Tainted san = Tainted::NO );
   explicit String( const std::string& str, Tainted san = Tainted::NO );
   explicit String( const std::string_view& str, Tainted san = Tainted::NO );
   explicit String( BObjectImp& objimp );
-  String( const String& str ) : BObjectImp( OTString ), value_( str.value_ ) {}
+  String( const String& str )
+      : BObjectImp( OTString ), value_( str.value_ ), codepoints_( str.codepoints_ ), index_()
+  {
+  }
   virtual ~String() = default;
 
 private:
@@ -78,17 +83,24 @@ public:
   String& operator=( const char* s )
   {
     value_ = s;
+    resetIndex();
     return *this;
   }
   String& operator=( const String& str )
   {
-    value_ = str.value_;
+    copyvalue( str );
     return *this;
   }
-  void copyvalue( const String& str ) { value_ = str.value_; }
+  void copyvalue( const String& str )
+  {
+    value_ = str.value_;
+    resetIndex();
+    codepoints_ = str.codepoints_;
+  }
 
 private:
   void remove( const std::string& s );
+  void append( const std::string& s );
   virtual bool isTrue() const override { return !value_.empty(); }
 
 public:
@@ -145,9 +157,26 @@ protected:
                                       bool forcebuiltin = false ) override;
 
 private:
-  size_t getBytePosition( std::string::const_iterator* itr, size_t codeindex ) const;
+  static constexpr size_t INDEX_STRIDE = 32;
+
+  // byte position codeindex code points after byte position pos, npos if beyond the end
+  size_t getBytePosition( size_t pos, size_t codeindex ) const;
+  // code point index of byte position pos
+  size_t getCodePointIndex( size_t pos ) const;
+  bool isASCII() const { return length() == value_.size(); }
+  void buildIndex() const;
+  void resetIndex()
+  {
+    codepoints_ = std::string::npos;
+    index_.reset();
+  }
 
   std::string value_;
+  // Number of code points (npos if not known yet) and byte position of every INDEX_STRIDE-th
+  // code point, created on demand. The value is pure ASCII if both lengths are equal, in that case
+  // no index is needed. Every modification of value_ has to reset or update them.
+  mutable size_t codepoints_;
+  mutable std::unique_ptr<std::vector<u32>> index_;
   friend class SubString;
 };
 
@@ -1531,7 +1531,7 @@ BObjectImp* ObjArray::call_method_id( const int id, Executor& ex, bool /*forcebu
           BObjectRef tmp;
           ref_arr.insert( ref_arr.begin() + idx, tmp );
           BObjectRef& ref = ref_arr[idx];
-          ref.set( new BObject( imp->copy() ) );
+          ref.set( new BObject( ex.takeParamImp( 1 ) ) );
         }
         else
         {
@@ -1570,7 +1570,7 @@ BObjectImp* ObjArray::call_method_id( const int id, Executor& ex, bool /*forcebu
         BObjectImp* imp = ex.getParamImp( 0 );
         if ( imp )
         {
-          ref_arr.push_back( BObjectRef( new BObject( imp->copy() ) ) );
+          ref_arr.push_back( BObjectRef( new BObject( ex.takeParamImp( 0 ) ) ) );
 
           return new BLong( 1 );
         }
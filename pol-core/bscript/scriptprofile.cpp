@@ -0,0 +1,199 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "scriptprofile.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+#include "../clib/stlutil.h"
+#include "eprog.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+std::atomic<unsigned> ScriptProfile::sample_interval( 0 );
+
+namespace
+{
+// executors of the same program may run in different threads, samples are rare enough for a
+// single lock
+std::mutex profile_mutex;
+
+const EPDbgFunction* function_at( const EScriptProgram& prog, unsigned PC )
+{
+  for ( const auto& func : prog.dbg_functions )
+  {
+    if ( PC >= func.firstPC && PC <= func.lastPC )
+      return &func;
+  }
+  return nullptr;
+}
+
+std::string function_name( const EScriptProgram& prog, unsigned PC )
+{
+  const EPDbgFunction* func = function_at( prog, PC );
+  return func != nullptr ? func->name : std::string( "<program>" );
+}
+
+std::string line_name( const EScriptProgram& prog, unsigned PC )
+{
+  if ( PC >= prog.dbg_linenum.size() || PC >= prog.dbg_filenum.size() ||
+       prog.dbg_filenum[PC] >= prog.dbg_filenames.size() )
+    return fmt::format( "PC{}", PC );
+  return fmt::format( "{}:{}", prog.dbg_filenames[prog.dbg_filenum[PC]], prog.dbg_linenum[PC] );
+}
+
+void sort_hotspots( std::vector<ScriptProfile::Hotspot>& spots )
+{
+  std::sort( spots.begin(), spots.end(),
+             []( const ScriptProfile::Hotspot& a, const ScriptProfile::Hotspot& b )
+             {
+               if ( a.nanoseconds != b.nanoseconds )
+                 return a.nanoseconds > b.nanoseconds;
+               return a.instructions > b.instructions;
+             } );
+}
+}  // namespace
+
+void ScriptProfile::add_sample( EScriptProgram& prog, std::vector<unsigned>&& stack,
+                                u64 estimated_nanoseconds )
+{
+  std::lock_guard<std::mutex> lock( profile_mutex );
+  if ( !prog.profile )
+    prog.profile.reset( new ScriptProfile );
+  auto& sample = prog.profile->_stacks[std::move( stack )];
+  ++sample.count;
+  sample.nanoseconds += estimated_nanoseconds;
+}
+
+void ScriptProfile::clear( EScriptProgram& prog )
+{
+  {
+    std::lock_guard<std::mutex> lock( profile_mutex );
+    prog.profile.reset();
+  }
+  for ( const auto& ins : prog.instr )
+    ins.cycles = 0;
+}
+
+bool ScriptProfile::has_samples( const EScriptProgram& prog )
+{
+  std::lock_guard<std::mutex> lock( profile_mutex );
+  return prog.profile != nullptr;
+}
+
+void ScriptProfile::write_collapsed( EScriptProgram& prog, std::string& out )
+{
+  prog.read_dbg_file();
+  std::lock_guard<std::mutex> lock( profile_mutex );
+  if ( !prog.profile )
+    return;
+  for ( const auto& [stack, sample] : prog.profile->_stacks )
+  {
+    out += prog.name.get();
+    for ( size_t i = 0; i < stack.size(); ++i )
+    {
+      // every frame is named after its function, the innermost one additionally by its line
+      out += ';';
+      out += function_name( prog, stack[i] );
+      if ( i + 1 == stack.size() )
+      {
+        out += ':';
+        out += line_name( prog, stack[i] );
+      }
+    }
+    fmt::format_to( std::back_inserter( out ), " {}\n",
+                    std::max<u64>( 1, sample.nanoseconds / 1000 ) );
+  }
+}
+
+std::vector<ScriptProfile::Hotspot> ScriptProfile::functions( EScriptProgram& prog )
+{
+  prog.read_dbg_file();
+  std::vector<Hotspot> spots;
+  spots.reserve( prog.dbg_functions.size() + 1 );
+  std::unordered_map<const EPDbgFunction*, size_t> index;
+  auto spot_at = [&]( unsigned PC ) -> Hotspot&
+  {
+    const EPDbgFunction* func = function_at( prog, PC );
+    auto itr = index.find( func );
+    if ( itr == index.end() )
+    {
+      itr = index.emplace( func, spots.size() ).first;
+      spots.emplace_back();
+      spots.back().name = func != nullptr ? func->name : std::string( "<program>" );
+    }
+    return spots[itr->second];
+  };
+
+  for ( unsigned PC = 0; PC < prog.instr.size(); ++PC )
+  {
+    if ( prog.instr[PC].cycles )
+      spot_at( PC ).instructions += prog.instr[PC].cycles;
+  }
+  std::lock_guard<std::mutex> lock( profile_mutex );
+  if ( prog.profile )
+  {
+    for ( const auto& [stack, sample] : prog.profile->_stacks )
+    {
+      // self time: only the executing function gets the sample
+      Hotspot& spot = spot_at( stack.back() );
+      spot.samples += sample.count;
+      spot.nanoseconds += sample.nanoseconds;
+    }
+  }
+  sort_hotspots( spots );
+  return spots;
+}
+
+std::vector<ScriptProfile::Hotspot> ScriptProfile::lines( EScriptProgram& prog, size_t max_count )
+{
+  prog.read_dbg_file();
+  std::map<std::string, Hotspot> by_line;
+  for ( unsigned PC = 0; PC < prog.instr.size(); ++PC )
+  {
+    if ( prog.instr[PC].cycles )
+      by_line[line_name( prog, PC )].instructions += prog.instr[PC].cycles;
+  }
+  {
+    std::lock_guard<std::mutex> lock( profile_mutex );
+    if ( prog.profile )
+    {
+      for ( const auto& [stack, sample] : prog.profile->_stacks )
+      {
+        Hotspot& spot = by_line[line_name( prog, stack.back() )];
+        spot.samples += sample.count;
+        spot.nanoseconds += sample.nanoseconds;
+      }
+    }
+  }
+  std::vector<Hotspot> spots;
+  spots.reserve( by_line.size() );
+  for ( auto& [name, spot] : by_line )
+  {
+    spot.name = name;
+    spots.push_back( std::move( spot ) );
+  }
+  sort_hotspots( spots );
+  if ( spots.size() > max_count )
+    spots.resize( max_count );
+  return spots;
+}
+
+size_t ScriptProfile::sizeEstimate() const
+{
+  size_t size = sizeof( ScriptProfile ) + Clib::memsize( _stacks );
+  for ( const auto& stack : _stacks )
+    size += Clib::memsize( stack.first );
+  return size;
+}
+}  // namespace Bscript
+}  // namespace Pol
@@ -0,0 +1,69 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef BSCRIPT_SCRIPTPROFILE_H
+#define BSCRIPT_SCRIPTPROFILE_H
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+class EScriptProgram;
+
+/**
+ * Sampling profile of one program, shared by all executors running it.
+ *
+ * While sampling is enabled every sample_interval-th instruction of an executor is timed and
+ * accounted to its call stack: the call sites of the active user functions followed by the
+ * sampled instruction, all as program counters. Symbolization happens only when reporting,
+ * using the .dbg file of the program.
+ */
+class ScriptProfile
+{
+public:
+  struct Sample
+  {
+    u64 count = 0;
+    u64 nanoseconds = 0;  // sampled time multiplied by the sample interval
+  };
+  struct Hotspot
+  {
+    std::string name;
+    u64 instructions = 0;
+    u64 samples = 0;
+    u64 nanoseconds = 0;  // sampled time multiplied by the sample interval
+  };
+
+  // 0 disables sampling
+  static std::atomic<unsigned> sample_interval;
+
+  static void add_sample( EScriptProgram& prog, std::vector<unsigned>&& stack,
+                          u64 estimated_nanoseconds );
+  static void clear( EScriptProgram& prog );
+  static bool has_samples( const EScriptProgram& prog );
+
+  // one "script;function;function:line weight" line per stack (flamegraph.pl input), the weight
+  // is the estimated time in microseconds
+  static void write_collapsed( EScriptProgram& prog, std::string& out );
+  // sorted by descending estimated time, falls back to instruction counts without samples
+  static std::vector<Hotspot> functions( EScriptProgram& prog );
+  static std::vector<Hotspot> lines( EScriptProgram& prog, size_t max_count );
+
+  size_t sizeEstimate() const;
+
+private:
+  std::map<std::vector<unsigned>, Sample> _stacks;
+};
+}  // namespace Bscript
+}  // namespace Pol
+#endif
@@ -8,9 +8,11 @@
  * sense.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctype.h>
 #include <cwctype>
+#include <iterator>
 #include <string>
 #include <utf8/utf8.h>
 
@@ -38,32 +40,42 @@ namespace Pol
 {
 namespace Bscript
 {
-String::String( BObjectImp& objimp ) : BObjectImp( OTString ), value_( objimp.getStringRep() ) {}
+String::String( BObjectImp& objimp )
+    : BObjectImp( OTString ),
+      value_( objimp.getStringRep() ),
+      codepoints_( std::string::npos ),
+      index_()
+{
+}
 
-String::String( const char* s, size_t len, Tainted san ) : BObjectImp( OTString ), value_( s, len )
+String::String( const char* s, size_t len, Tainted san )
+    : BObjectImp( OTString ), value_( s, len ), codepoints_( std::string::npos ), index_()
 {
   if ( san == Tainted::YES )
     Clib::sanitizeUnicodeWithIso( &value_ );
 }
 
 String::String( const std::string& str, std::string::size_type pos, std::string::size_type n )
-    : BObjectImp( OTString ), value_( str, pos, n )
+    : BObjectImp( OTString ), value_( str, pos, n ), codepoints_( std::string::npos ), index_()
 {
 }
 
-String::String( const char* str, Tainted san ) : BObjectImp( OTString ), value_( str )
+String::String( const char* str, Tainted san )
+    : BObjectImp( OTString ), value_( str ), codepoints_( std::string::npos ), index_()
 {
   if ( san == Tainted::YES )
     Clib::sanitizeUnicodeWithIso( &value_ );
 }
 
-String::String( const std::string& str, Tainted san ) : BObjectImp( OTString ), value_( str )
+String::String( const std::string& str, Tainted san )
+    : BObjectImp( OTString ), value_( str ), codepoints_( std::string::npos ), index_()
 {
   if ( san == Tainted::YES )
     Clib::sanitizeUnicodeWithIso( &value_ );
 }
 
-String::String( const std::string_view& str, Tainted san ) : BObjectImp( OTString ), value_( str )
+String::String( const std::string_view& str, Tainted san )
+    : BObjectImp( OTString ), value_( str ), codepoints_( std::string::npos ), index_()
 {
   if ( san == Tainted::YES )
     Clib::sanitizeUnicodeWithIso( &value_ );
@@ -71,10 +83,9 @@ String::String( const std::string_view& str, Tainted san ) : BObjectImp( OTStrin
 
 String* String::StrStr( int begin, int len ) const
 {
-  auto itr = value_.cbegin();
   --begin;
-  size_t startpos = getBytePosition( &itr, begin );
-  size_t endpos = getBytePosition( &itr, len );
+  size_t startpos = getBytePosition( 0, begin );
+  size_t endpos = getBytePosition( startpos, len );
   if ( startpos != std::string::npos )
     return new String( value_.substr( startpos, endpos - startpos ) );
   return new String( value_ );
@@ -82,7 +93,78 @@ String* String::StrStr( int begin, int len ) const
 
 size_t String::length() const
 {
-  return utf8::unchecked::distance( value_.begin(), value_.end() );
+  if ( codepoints_ == std::string::npos )
+  {
+    if ( hasUTF8Characters( value_ ) )
+      buildIndex();
+    else
+      codepoints_ = value_.size();
+  }
+  return codepoints_;
+}
+
+void String::buildIndex() const
+{
+  auto index = std::make_unique<std::vector<u32>>();
+  index->reserve( value_.size() / INDEX_STRIDE + 1 );
+  size_t count = 0;
+  for ( auto itr = value_.cbegin(); itr < value_.cend(); utf8::unchecked::next( itr ), ++count )
+  {
+    if ( count % INDEX_STRIDE == 0 )
+      index->push_back( static_cast<u32>( std::distance( value_.cbegin(), itr ) ) );
+  }
+  codepoints_ = count;
+  index_ = std::move( index );
+}
+
+size_t String::getBytePosition( size_t pos, size_t codeindex ) const
+{
+  if ( pos >= value_.size() )
+    return std::string::npos;
+  size_t start = getCodePointIndex( pos );
+  if ( codeindex >= length() - start )
+    return std::string::npos;
+  size_t target = start + codeindex;
+  if ( isASCII() )
+    return target;
+  if ( !index_ )
+    buildIndex();
+  // walk from the nearest indexed code point, or from pos if that is closer
+  size_t cp = target - target % INDEX_STRIDE;
+  auto itr = value_.cbegin();
+  if ( cp > start )
+  {
+    std::advance( itr, ( *index_ )[cp / INDEX_STRIDE] );
+  }
+  else
+  {
+    std::advance( itr, pos );
+    cp = start;
+  }
+  for ( ; cp < target && itr < value_.cend(); ++cp )
+    utf8::unchecked::next( itr );
+  return std::distance( value_.cbegin(), itr );
+}
+
+size_t String::getCodePointIndex( size_t pos ) const
+{
+  if ( isASCII() )
+    return std::min( pos, value_.size() );
+  if ( !index_ )
+    buildIndex();
+  auto indexed = std::upper_bound( index_->cbegin(), index_->cend(), pos );
+  size_t cp = 0;
+  auto itr = value_.cbegin();
+  if ( indexed != index_->cbegin() )
+  {
+    --indexed;
+    cp = std::distance( index_->cbegin(), indexed ) * INDEX_STRIDE;
+    std::advance( itr, *indexed );
+  }
+  auto end = value_.cbegin() + std::min( pos, value_.size() );
+  for ( ; itr < end; ++cp )
+    utf8::unchecked::next( itr );
+  return cp;
 }
 
 String* String::ETrim( const char* CRSet, int type ) const
@@ -134,16 +216,19 @@ void String::EStrReplace( String* str1, String* str2 )
   {
     value_.replace( valpos, str1->value_.size(), str2->value_ );
     valpos += str2->value_.size();
+    resetIndex();
   }
 }
 
 void String::ESubStrReplace( String* replace_with, unsigned int index, unsigned int len )
 {
-  auto itr = value_.cbegin();
-  size_t begin = getBytePosition( &itr, index - 1 );
-  size_t end = getBytePosition( &itr, len );
+  size_t begin = getBytePosition( 0, index - 1 );
+  size_t end = getBytePosition( begin, len );
   if ( begin != std::string::npos )
+  {
     value_.replace( begin, end - begin, replace_with->value_ );
+    resetIndex();
+  }
 }
 
 std::string String::pack() const
@@ -204,7 +289,10 @@ BObjectImp* String::unpackWithLen( std::istream& is )
 
 size_t String::sizeEstimate() const
 {
-  return sizeof( String ) + value_.capacity();
+  size_t size = sizeof( String ) + value_.capacity();
+  if ( index_ )
+    size += Clib::memsize( *index_ );
+  return size;
 }
 
 /*
@@ -215,16 +303,12 @@ size_t String::sizeEstimate() const
 int String::find( int begin, const char* target ) const
 {
   // returns -1 when begin is out of range for string
-  auto itr = value_.cbegin();
-  size_t pos = getBytePosition( &itr, begin );
+  size_t pos = getBytePosition( 0, begin );
   pos = value_.find( target, pos );
   if ( pos == std::string::npos )
     return -1;
   else
-  {
-    pos = utf8::unchecked::distance( value_.cbegin(), std::next( value_.cbegin(), pos ) );
-    return static_cast<int>( pos );
-  }
+    return static_cast<int>( getCodePointIndex( pos ) );
 }
 
 unsigned int String::SafeCharAmt() const
@@ -282,31 +366,55 @@ void String::selfPlusObjImp( BObjectImp& objimp, BObject& obj )
 }
 void String::selfPlusObj( BObjectImp& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  append( objimp.getStringRep() );
 }
 void String::selfPlusObj( BLong& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  append( objimp.getStringRep() );
 }
 void String::selfPlusObj( Double& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  append( objimp.getStringRep() );
 }
 void String::selfPlusObj( String& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  append( objimp.getStringRep() );
 }
 void String::selfPlusObj( ObjArray& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  append( objimp.getStringRep() );
 }
 
 
+void String::append( const std::string& str )
+{
+  // appending ASCII keeps the index valid
+  if ( codepoints_ == std::string::npos || hasUTF8Characters( str ) )
+  {
+    value_ += str;
+    resetIndex();
+    return;
+  }
+  size_t oldsize = value_.size();
+  size_t added = str.size();
+  value_ += str;
+  if ( index_ )
+  {
+    size_t cp = ( codepoints_ + INDEX_STRIDE - 1 ) / INDEX_STRIDE * INDEX_STRIDE;
+    for ( ; cp < codepoints_ + added; cp += INDEX_STRIDE )
+      index_->push_back( static_cast<u32>( oldsize + cp - codepoints_ ) );
+  }
+  codepoints_ += added;
+}
+
 void String::remove( const std::string& rm )
 {
   auto pos = value_.find( rm );
   if ( pos != std::string::npos )
+  {
     value_.erase( pos, rm.size() );
+    resetIndex();
+  }
 }
 
 BObjectImp* String::selfMinusObjImp( const BObjectImp& objimp ) const
@@ -412,6 +520,7 @@ void String::toUpper()
     Clib::mkupperASCII( value_ );
     return;
   }
+  resetIndex();
 #ifndef WINDOWS
   std::vector<wchar_t> codes = convertutf8<wchar_t>( value_ );
   value_.clear();
@@ -451,6 +560,7 @@ void String::toLower()
     Clib::mklowerASCII( value_ );
     return;
   }
+  resetIndex();
 #ifndef WINDOWS
   std::vector<wchar_t> codes = convertutf8<wchar_t>( value_ );
   value_.clear();
@@ -483,19 +593,6 @@ void String::toLower()
 #endif
 }
 
-size_t String::getBytePosition( std::string::const_iterator* itr, size_t codeindex ) const
-{
-  auto itr_end = value_.cend();
-  for ( size_t i = 0; i < codeindex && *itr != itr_end; ++i )
-    utf8::unchecked::next( *itr );
-
-  if ( *itr != itr_end )
-  {
-    return std::distance( value_.cbegin(), *itr );
-  }
-  return std::string::npos;
-}
-
 BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*copy*/ )
 {
   std::string::size_type pos, len;
@@ -512,30 +609,26 @@ BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*co
     BLong& lng = (BLong&)*idx;
     len = 1;
     pos = lng.value() - 1;
-    auto itr = value_.cbegin();
-    pos = getBytePosition( &itr, pos );
+    pos = getBytePosition( 0, pos );
     if ( pos != std::string::npos )
     {
+      auto itr = value_.cbegin() + pos;
       utf8::unchecked::next( itr );
       len = std::distance( value_.cbegin(), itr ) - pos;
     }
-    else
-      pos = std::string::npos;
   }
   else if ( idx->isa( OTDouble ) )
   {
     Double& dbl = (Double&)*idx;
     pos = static_cast<std::string::size_type>( dbl.value() ) - 1;
     len = 1;
-    auto itr = value_.cbegin();
-    pos = getBytePosition( &itr, pos );
+    pos = getBytePosition( 0, pos );
     if ( pos != std::string::npos )
     {
+      auto itr = value_.cbegin() + pos;
       utf8::unchecked::next( itr );
       len = std::distance( value_.cbegin(), itr ) - pos;
     }
-    else
-      pos = std::string::npos;
   }
   else
   {
@@ -548,6 +641,7 @@ BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*co
     {
       String* target_str = (String*)target;
       value_.replace( pos, len, target_str->value_ );
+      resetIndex();
     }
     return this;
   }
@@ -579,8 +673,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
     if ( index == 0 || index > value_.size() )
       return BObjectRef( new BError( "Subscript out of range" ) );
     --index;
-    auto itr = value_.cbegin();
-    index = getBytePosition( &itr, index );
+    index = getBytePosition( 0, index );
     if ( index == std::string::npos )
       return BObjectRef( new BError( "Subscript out of range" ) );
   }
@@ -616,9 +709,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   {
     return BObjectRef( copy() );
   }
-  auto itr = value_.cbegin();
-  std::advance( itr, index );
-  size_t index_len = getBytePosition( &itr, len );
+  size_t index_len = getBytePosition( index, len );
 
   if ( index_len != std::string::npos )
     len = index_len - index;
@@ -629,6 +720,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   {
     String* target_str = (String*)target;
     value_.replace( index, len, target_str->value_ );
+    resetIndex();
   }
   else
   {
@@ -661,8 +753,7 @@ BObjectRef String::OperMultiSubscript( std::stack<BObjectRef>& indices )
     if ( index == 0 || index > value_.size() )
       return BObjectRef( new BError( "Subscript out of range" ) );
     --index;
-    auto itr = value_.cbegin();
-    index = getBytePosition( &itr, index );
+    index = getBytePosition( 0, index );
     if ( index == std::string::npos )
       return BObjectRef( new BError( "Subscript out of range" ) );
   }
@@ -698,9 +789,7 @@ BObjectRef String::OperMultiSubscript( std::stack<BObjectRef>& indices )
   {
     return BObjectRef( copy() );
   }
-  auto itr = value_.cbegin();
-  std::advance( itr, index );
-  size_t index_len = getBytePosition( &itr, len );
+  size_t index_len = getBytePosition( index, len );
 
   if ( index_len != std::string::npos )
     len = index_len - index;
@@ -725,10 +814,10 @@ BObjectRef String::OperSubscript( const BObject& rightobj )
       return BObjectRef( new BError( "Subscript out of range" ) );
 
     --index;
-    auto itr = value_.cbegin();
-    index = getBytePosition( &itr, index );
+    index = getBytePosition( 0, index );
     if ( index != std::string::npos )
     {
+      auto itr = value_.cbegin() + index;
       utf8::unchecked::next( itr );
       size_t len = std::distance( value_.cbegin(), itr ) - index;
       return BObjectRef( new BObject( new String( value_.c_str() + index, len ) ) );
@@ -747,10 +836,10 @@ BObjectRef String::OperSubscript( const BObject& rightobj )
       return BObjectRef( new BError( "Subscript out of range" ) );
 
     --index;
-    auto itr = value_.cbegin();
-    index = getBytePosition( &itr, index );
+    index = getBytePosition( 0, index );
     if ( index != std::string::npos )
     {
+      auto itr = value_.cbegin() + index;
       utf8::unchecked::next( itr );
       size_t len = std::distance( value_.cbegin(), itr ) - index;
       return BObjectRef( new BObject( new String( value_.c_str() + index, len ) ) );
@@ -1129,6 +1218,8 @@ BObjectImp* String::call_method_id( const int id, Executor& ex, bool /*forcebuil
 
 bool String::hasUTF8Characters() const
 {
+  if ( codepoints_ != std::string::npos )
+    return codepoints_ != value_.size();
   return hasUTF8Characters( value_ );
 }
 
@@ -1222,20 +1313,17 @@ bool String::compare( const String& str ) const
 
 bool String::compare( size_t pos1, size_t len1, const String& str ) const
 {
-  auto itr1 = value_.cbegin();
-  pos1 = getBytePosition( &itr1, pos1 );
-  len1 = getBytePosition( &itr1, len1 ) - pos1;
+  pos1 = getBytePosition( 0, pos1 );
+  len1 = getBytePosition( pos1, len1 ) - pos1;
   return value_.compare( pos1, len1, str.value_ ) == 0;
 }
 
 bool String::compare( size_t pos1, size_t len1, const String& str, size_t pos2, size_t len2 ) const
 {
-  auto itr1 = value_.cbegin();
-  pos1 = getBytePosition( &itr1, pos1 );
-  len1 = getBytePosition( &itr1, len1 ) - pos1;
-  auto itr2 = str.value_.cbegin();
-  pos2 = str.getBytePosition( &itr2, pos2 );
-  len2 = str.getBytePosition( &itr2, len2 ) - pos2;
+  pos1 = getBytePosition( 0, pos1 );
+  len1 = getBytePosition( pos1, len1 ) - pos1;
+  pos2 = str.getBytePosition( 0, pos2 );
+  len2 = str.getBytePosition( pos2, len2 ) - pos2;
   return value_.compare( pos1, len1, str.value_, pos2, len2 ) == 0;
 }
 
@@ -19,6 +19,8 @@ set (clib_sources
   cfgelem.h
   cfgfile.cpp 
   cfgfile.h
+  cfgprefetch.cpp
+  cfgprefetch.h
   cfgsect.cpp
   cfgsect.h
   clib.h
@@ -22,6 +22,16 @@ public:
   virtual void addMessage( const std::string& msg ) = 0;
   virtual void addMessage( const std::string& msg, const std::string& id ) = 0;
 
+  /**
+   * Writes buffered messages, unless the flush interval of the sink didn't pass yet
+   */
+  virtual void flush( bool /*force*/ ) {}
+
+  /**
+   * Messages of the sink are dropped instead of waiting while the log queue is full
+   */
+  static constexpr bool dropOnOverflow = false;
+
   /**
    * Helper function to print timestamp into stream
    */
@@ -9,6 +9,7 @@
 #include "maputil.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 namespace Pol
@@ -112,8 +113,23 @@ public:
 
 protected:
   [[noreturn]] void prop_not_found( const char* propname ) const;
-  typedef std::multimap<std::string, std::string, ci_cmp_pred> Props;
+
+  struct Property
+  {
+    std::string name;
+    std::string value;
+    size_t hash;  // case insensitive hash of name
+  };
+  // kept in file order, elements rarely have more than a few dozen properties
+  // until remove_first_prop sorts them once, see sorted_for_removal
+  typedef std::vector<Property> Props;
+  Props::iterator find_prop( const char* propname );
+  Props::const_iterator find_prop( const char* propname ) const;
+  void emplace_prop( std::string propname, std::string propval );
   Props properties;
+  // descending by name, equal names in reverse file order: the next property
+  // remove_first_prop hands out is at the back
+  bool sorted_for_removal = false;
 };
 
 class VectorConfigElem : public ConfigElemBase
@@ -9,8 +9,10 @@
 
 #include "cfgfile.h"
 
+#include <algorithm>
 #include <ctype.h>
 #include <exception>
+#include <iterator>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -28,6 +30,18 @@ namespace Clib
 {
 namespace
 {
+size_t prop_hash( const char* name, size_t len )
+{
+  // FNV-1a over the lower case name, properties are matched case insensitive
+  size_t hash = 14695981039346656037ull;
+  for ( size_t i = 0; i < len; ++i )
+  {
+    hash ^= static_cast<unsigned char>( tolower( static_cast<unsigned char>( name[i] ) ) );
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
 bool commentline( const std::string& str )
 {
 #ifdef __GNUC__
@@ -55,7 +69,51 @@ ConfigElem::~ConfigElem() {}
 
 size_t ConfigElem::estimateSize() const
 {
-  return ConfigElemBase::estimateSize() + Clib::memsize( properties );
+  return ConfigElemBase::estimateSize() +
+         Clib::memsize( properties,
+                        []( const Property& prop )
+                        { return sizeof( Property ) + prop.name.capacity() + prop.value.capacity(); } );
+}
+
+ConfigElem::Props::iterator ConfigElem::find_prop( const char* propname )
+{
+  size_t hash = prop_hash( propname, strlen( propname ) );
+  if ( sorted_for_removal )
+  {
+    // equal names are in reverse file order, the first one in the file is the last
+    for ( auto itr = properties.rbegin(), end = properties.rend(); itr != end; ++itr )
+    {
+      if ( itr->hash == hash && stricmp( itr->name.c_str(), propname ) == 0 )
+        return std::prev( itr.base() );
+    }
+    return properties.end();
+  }
+  for ( auto itr = properties.begin(), end = properties.end(); itr != end; ++itr )
+  {
+    if ( itr->hash == hash && stricmp( itr->name.c_str(), propname ) == 0 )
+      return itr;
+  }
+  return properties.end();
+}
+
+ConfigElem::Props::const_iterator ConfigElem::find_prop( const char* propname ) const
+{
+  return const_cast<ConfigElem*>( this )->find_prop( propname );
+}
+
+void ConfigElem::emplace_prop( std::string propname, std::string propval )
+{
+  size_t hash = prop_hash( propname.c_str(), propname.size() );
+  if ( sorted_for_removal )
+  {
+    // the newest property goes in front of the ones with an equal name
+    auto pos = std::lower_bound( properties.begin(), properties.end(), propname,
+                                 []( const Property& prop, const std::string& name )
+                                 { return stricmp( prop.name.c_str(), name.c_str() ) > 0; } );
+    properties.insert( pos, Property{ std::move( propname ), std::move( propval ), hash } );
+    return;
+  }
+  properties.push_back( Property{ std::move( propname ), std::move( propval ), hash } );
 }
 
 
@@ -93,21 +151,31 @@ bool ConfigElemBase::type_is( const char* type ) const
   return ( stricmp( type_.c_str(), type ) == 0 );
 }
 
+// hands out the properties ordered by name, equal names in file order
 bool ConfigElem::remove_first_prop( std::string* propname, std::string* value )
 {
   if ( properties.empty() )
     return false;
 
-  auto itr = properties.begin();
-  *propname = ( *itr ).first;
-  *value = ( *itr ).second;
-  properties.erase( itr );
+  if ( !sorted_for_removal )
+  {
+    // sorted once, draining an element pops from the back
+    std::reverse( properties.begin(), properties.end() );
+    std::stable_sort( properties.begin(), properties.end(),
+                      []( const Property& a, const Property& b )
+                      { return stricmp( a.name.c_str(), b.name.c_str() ) > 0; } );
+    sorted_for_removal = true;
+  }
+  Property& first = properties.back();
+  *propname = std::move( first.name );
+  *value = std::move( first.value );
+  properties.pop_back();
   return true;
 }
 
 bool ConfigElem::has_prop( const char* propname ) const
 {
-  return properties.count( propname ) != 0;
+  return find_prop( propname ) != properties.end();
 }
 bool VectorConfigElem::has_prop( const char* propname ) const
 {
@@ -123,10 +191,10 @@ bool VectorConfigElem::has_prop( const char* propname ) const
 
 bool ConfigElem::remove_prop( const char* propname, std::string* value )
 {
-  auto itr = properties.find( propname );
+  auto itr = find_prop( propname );
   if ( itr != properties.end() )
   {
-    *value = ( *itr ).second;
+    *value = std::move( itr->value );
     properties.erase( itr );
     return true;
   }
@@ -154,10 +222,10 @@ bool VectorConfigElem::remove_prop( const char* propname, std::string* value )
 
 bool ConfigElem::read_prop( const char* propname, std::string* value ) const
 {
-  auto itr = properties.find( propname );
+  auto itr = find_prop( propname );
   if ( itr != properties.end() )
   {
-    *value = ( *itr ).second;
+    *value = itr->value;
     return true;
   }
   else
@@ -180,10 +248,10 @@ bool VectorConfigElem::read_prop( const char* propname, std::string* value ) con
 
 void ConfigElem::get_prop( const char* propname, unsigned int* plong ) const
 {
-  auto itr = properties.find( propname );
+  auto itr = find_prop( propname );
   if ( itr != properties.end() )
   {
-    *plong = strtoul( ( *itr ).second.c_str(), nullptr, 0 );
+    *plong = strtoul( itr->value.c_str(), nullptr, 0 );
   }
   else
   {
@@ -193,10 +261,10 @@ void ConfigElem::get_prop( const char* propname, unsigned int* plong ) const
 
 bool ConfigElem::remove_prop( const char* propname, unsigned int* plong )
 {
-  auto itr = properties.find( propname );
+  auto itr = find_prop( propname );
   if ( itr != properties.end() )
   {
-    *plong = strtoul( ( *itr ).second.c_str(), nullptr, 0 );
+    *plong = strtoul( itr->value.c_str(), nullptr, 0 );
     properties.erase( itr );
     return true;
   }
@@ -483,7 +551,7 @@ void ConfigElem::clear_prop( const char* propname )
 
 void ConfigElem::add_prop( std::string propname, std::string propval )
 {
-  properties.emplace( std::move( propname ), std::move( propval ) );
+  emplace_prop( std::move( propname ), std::move( propval ) );
 }
 void VectorConfigElem::add_prop( std::string propname, std::string propval )
 {
@@ -494,11 +562,11 @@ void VectorConfigElem::add_prop( std::string propname, std::string propval )
 
 void ConfigElem::add_prop( std::string propname, unsigned short sval )
 {
-  properties.emplace( std::move( propname ), std::to_string( sval ) );
+  emplace_prop( std::move( propname ), std::to_string( sval ) );
 }
 void ConfigElem::add_prop( std::string propname, short sval )
 {
-  properties.emplace( std::move( propname ), std::to_string( sval ) );
+  emplace_prop( std::move( propname ), std::to_string( sval ) );
 }
 
 void VectorConfigElem::add_prop( std::string propname, unsigned short sval )
@@ -510,7 +578,7 @@ void VectorConfigElem::add_prop( std::string propname, unsigned short sval )
 
 void ConfigElem::add_prop( std::string propname, unsigned int lval )
 {
-  properties.emplace( std::move( propname ), std::to_string( lval ) );
+  emplace_prop( std::move( propname ), std::to_string( lval ) );
 }
 void VectorConfigElem::add_prop( std::string propname, unsigned int lval )
 {
@@ -539,6 +607,9 @@ ConfigFile::ConfigFile( const char* i_filename, const char* allowed_types_str )
       ifs(),
 #else
       fp( nullptr ),
+      _buffer(),
+      _buffer_pos( 0 ),
+      _buffer_len( 0 ),
 #endif
       _element_line_start( 0 ),
       _cur_line( 0 )
@@ -553,6 +624,9 @@ ConfigFile::ConfigFile( const std::string& i_filename, const char* allowed_types
       ifs(),
 #else
       fp( nullptr ),
+      _buffer(),
+      _buffer_pos( 0 ),
+      _buffer_len( 0 ),
 #endif
       _element_line_start( 0 ),
       _cur_line( 0 )
@@ -611,6 +685,8 @@ void ConfigFile::open( const char* i_filename )
                     std::strerror( errno ) );
     throw std::runtime_error( std::string( "Unable to open configuration file " ) + _filename );
   }
+  _buffer.resize( 64 * 1024 );
+  _buffer_pos = _buffer_len = 0;
 #endif
 
   struct stat cfgstat;
@@ -627,10 +703,6 @@ ConfigFile::~ConfigFile()
 #endif
 }
 
-#if !CFGFILE_USES_IOSTREAMS
-char ConfigFile::buffer[1024];
-#endif
-
 #if CFGFILE_USES_IOSTREAMS
 // returns true if ended on a }, false if ended on EOF.
 bool ConfigFile::read_properties( ConfigElem& elem )
@@ -740,36 +812,40 @@ bool ConfigFile::_read( ConfigElem& elem )
 
 bool ConfigFile::readline( std::string& strbuf )
 {
-  if ( !fgets( buffer, sizeof buffer, fp ) )
-    return false;
-
-  strbuf = "";
-
-  do
+  strbuf.clear();
+  bool any = false;
+  for ( ;; )
   {
-    char* nl = strchr( buffer, '\n' );
-    if ( nl )
+    if ( _buffer_pos >= _buffer_len )
     {
-      if ( nl != buffer && *( nl - 1 ) == '\r' )
-        --nl;
-      *nl = '\0';
-      strbuf += buffer;
-      return true;
+      _buffer_len = fread( _buffer.data(), 1, _buffer.size(), fp );
+      _buffer_pos = 0;
+      if ( !_buffer_len )
+        return any;
     }
-    else
+    any = true;
+
+    const char* start = _buffer.data() + _buffer_pos;
+    size_t avail = _buffer_len - _buffer_pos;
+    const char* nl = static_cast<const char*>( memchr( start, '\n', avail ) );
+    if ( nl )
     {
-      strbuf += buffer;
+      strbuf.append( start, nl );
+      _buffer_pos += nl - start + 1;
+      if ( !strbuf.empty() && strbuf.back() == '\r' )
+        strbuf.pop_back();
+      return true;
     }
-  } while ( fgets( buffer, sizeof buffer, fp ) );
-
-  return true;
+    strbuf.append( start, avail );
+    _buffer_pos = _buffer_len;
+  }
 }
 
 // returns true if ended on a }, false if ended on EOF.
 bool ConfigFile::read_properties( ConfigElem& elem )
 {
-  static std::string strbuf;
-  static std::string propname, propvalue;
+  thread_local std::string strbuf;
+  thread_local std::string propname, propvalue;
   while ( readline( strbuf ) )
   {
     if ( !_cur_line )
@@ -778,9 +854,6 @@ bool ConfigFile::read_properties( ConfigElem& elem )
 
     sanitizeUnicodeWithIso( &strbuf );
 
-    ISTRINGSTREAM is( strbuf );
-
-
     splitnamevalue( strbuf, propname, propvalue );
 
     if ( propname.empty() ||  // empty line
@@ -797,14 +870,14 @@ bool ConfigFile::read_properties( ConfigElem& elem )
       decodequotedstring( propvalue );
     }
 
-    elem.properties.emplace( propname, propvalue );
+    elem.emplace_prop( propname, propvalue );
   }
   return false;
 }
 bool ConfigFile::read_properties( VectorConfigElem& elem )
 {
-  static std::string strbuf;
-  static std::string propname, propvalue;
+  thread_local std::string strbuf;
+  thread_local std::string propname, propvalue;
   while ( readline( strbuf ) )
   {
     if ( !_cur_line )
@@ -813,9 +886,6 @@ bool ConfigFile::read_properties( VectorConfigElem& elem )
 
     sanitizeUnicodeWithIso( &strbuf );
 
-    ISTRINGSTREAM is( strbuf );
-
-
     splitnamevalue( strbuf, propname, propvalue );
 
     if ( propname.empty() ||  // empty line
@@ -842,6 +912,7 @@ bool ConfigFile::read_properties( VectorConfigElem& elem )
 bool ConfigFile::_read( ConfigElem& elem )
 {
   elem.properties.clear();
+  elem.sorted_for_removal = false;
 
   elem.type_ = "";
   elem.rest_ = "";
@@ -887,9 +958,8 @@ bool ConfigFile::_read( ConfigElem& elem )
 
     elem.rest_ = rest;
 
-    if ( !fgets( buffer, sizeof buffer, fp ) )
+    if ( !readline( strbuf ) )
       throw std::runtime_error( "File ends after element type -- expected a '{'" );
-    strbuf = buffer;
     ++_cur_line;
     sanitizeUnicodeWithIso( &strbuf );
 
@@ -956,9 +1026,8 @@ bool ConfigFile::_read( VectorConfigElem& elem )
 
     elem.rest_ = rest;
 
-    if ( !fgets( buffer, sizeof buffer, fp ) )
+    if ( !readline( strbuf ) )
       throw std::runtime_error( "File ends after element type -- expected a '{'" );
-    strbuf = buffer;
     ++_cur_line;
     sanitizeUnicodeWithIso( &strbuf );
 
@@ -79,7 +79,10 @@ private:
   std::ifstream ifs;
 #else
   FILE* fp;
-  static char buffer[1024];
+  // read ahead of fp, lines are cut out of it
+  std::vector<char> _buffer;
+  size_t _buffer_pos;
+  size_t _buffer_len;
 #endif
   int _element_line_start;  // what line in the file did this elem start on?
   int _cur_line;
@@ -0,0 +1,186 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "cfgprefetch.h"
+
+#include <string.h>
+
+#include "logfacility.h"
+#include "threadhelp.h"
+
+namespace Pol
+{
+namespace Clib
+{
+namespace
+{
+const size_t batch_size = 1000;
+const size_t max_batches = 8;
+}  // namespace
+
+ConfigFilePrefetcher::Source::Source( const std::string& filename_ )
+    : filename( filename_ ), line( 0 )
+{
+}
+
+void ConfigFilePrefetcher::Source::display_error( const std::string& msg, bool /*show_curline*/,
+                                                  const ConfigElemBase* elem, bool error ) const
+{
+  std::string tmp = fmt::format(
+      " {} reading configuration file {}:\n"
+      "\t{}",
+      error ? "Error" : "Warning", filename, msg );
+
+  if ( elem != nullptr && strlen( elem->type() ) > 0 )
+  {
+    tmp += fmt::format( "\n\tElement: {} {}", elem->type(), elem->rest() );
+    if ( line )
+      tmp += fmt::format( ", found on line {}", line );
+  }
+  ERROR_PRINTLN( tmp );
+}
+
+ConfigFilePrefetcher::ConfigFilePrefetcher( const std::string& filename,
+                                            const char* allowed_types )
+    : _cf( filename, allowed_types ),
+      _source( filename ),
+      _mutex(),
+      _cv(),
+      _batches(),
+      _finished( false ),
+      _stop( false ),
+      _error(),
+      _parse_time( 0 ),
+      _wait_time( 0 ),
+      _current(),
+      _pos( 0 ),
+      _thread()
+{
+  _thread = std::thread( [this]() { parse(); } );
+}
+
+ConfigFilePrefetcher::~ConfigFilePrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _stop = true;
+  }
+  _cv.notify_all();
+  _thread.join();
+}
+
+const std::string& ConfigFilePrefetcher::filename() const
+{
+  return _source.filename;
+}
+
+Tools::HighPerfTimer::time_mu ConfigFilePrefetcher::parse_time() const
+{
+  return _parse_time;
+}
+
+Tools::HighPerfTimer::time_mu ConfigFilePrefetcher::wait_time() const
+{
+  return _wait_time;
+}
+
+// returns false if the reader is gone
+bool ConfigFilePrefetcher::push( Batch& batch )
+{
+  std::unique_lock<std::mutex> lock( _mutex );
+  _cv.wait( lock, [this]() { return _batches.size() < max_batches || _stop; } );
+  if ( _stop )
+    return false;
+  if ( !batch.empty() )
+    _batches.push_back( std::move( batch ) );
+  lock.unlock();
+  _cv.notify_all();
+  return true;
+}
+
+void ConfigFilePrefetcher::parse()
+{
+  threadhelp::ThreadRegister register_thread( "ConfigFilePrefetcher " + _source.filename );
+  Tools::HighPerfTimer::time_mu parse_time( 0 );
+  std::exception_ptr error;
+  bool more = true;
+  while ( more )
+  {
+    Batch batch;
+    batch.reserve( batch_size );
+    Tools::HighPerfTimer timer;
+    try
+    {
+      while ( batch.size() < batch_size )
+      {
+        batch.emplace_back();
+        if ( !_cf.read( batch.back().elem ) )
+        {
+          batch.pop_back();
+          more = false;
+          break;
+        }
+        batch.back().line = _cf.element_line_start();
+      }
+    }
+    catch ( ... )
+    {
+      // the failed element is incomplete, everything before it is still handed out
+      batch.pop_back();
+      error = std::current_exception();
+      more = false;
+    }
+    parse_time += timer.ellapsed();
+    if ( !push( batch ) )
+      break;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _finished = true;
+    _error = error;
+    _parse_time = parse_time;
+  }
+  _cv.notify_all();
+}
+
+ConfigElem* ConfigFilePrefetcher::next()
+{
+  while ( _pos >= _current.size() )
+  {
+    Tools::HighPerfTimer timer;
+    std::unique_lock<std::mutex> lock( _mutex );
+    _cv.wait( lock, [this]() { return !_batches.empty() || _finished; } );
+    if ( _batches.empty() )
+    {
+      _wait_time += timer.ellapsed();
+      _current.clear();
+      _pos = 0;
+      if ( _error )
+      {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception( error );
+      }
+      return nullptr;
+    }
+    Batch batch = std::move( _batches.front() );
+    _batches.pop_front();
+    lock.unlock();
+    _cv.notify_all();
+    _wait_time += timer.ellapsed();
+
+    _current = std::move( batch );
+    _pos = 0;
+  }
+
+  Entry& entry = _current[_pos++];
+  _source.line = entry.line;
+  entry.elem.set_source( &_source );
+  return &entry.elem;
+}
+}  // namespace Clib
+}  // namespace Pol
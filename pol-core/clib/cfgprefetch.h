@@ -0,0 +1,89 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_CFGPREFETCH_H
+#define CLIB_CFGPREFETCH_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cfgelem.h"
+#include "cfgfile.h"
+#include "timer.h"
+
+namespace Pol
+{
+namespace Clib
+{
+/// Parses a config file on its own thread while the caller consumes the elements in file order.
+/// The parser stays at most a few batches ahead, so huge files are not held in memory.
+/// A parse error is rethrown by next() after all elements before it have been returned.
+/// eg:
+/// ConfigFilePrefetcher reader( "items.txt", "ITEM" );
+/// while ( ConfigElem* elem = reader.next() )
+///   create_item( *elem );
+class ConfigFilePrefetcher
+{
+public:
+  ConfigFilePrefetcher( const std::string& filename, const char* allowed_types = nullptr );
+  ~ConfigFilePrefetcher();
+  ConfigFilePrefetcher( const ConfigFilePrefetcher& ) = delete;
+  ConfigFilePrefetcher& operator=( const ConfigFilePrefetcher& ) = delete;
+
+  // the element stays valid until the next call, nullptr at the end of the file
+  ConfigElem* next();
+
+  const std::string& filename() const;
+  // time the parser thread spent reading, only complete once next() returned nullptr
+  Tools::HighPerfTimer::time_mu parse_time() const;
+  // time next() spent waiting for the parser
+  Tools::HighPerfTimer::time_mu wait_time() const;
+
+private:
+  struct Entry
+  {
+    ConfigElem elem;
+    unsigned line = 0;
+  };
+  typedef std::vector<Entry> Batch;
+
+  // reports errors of handed out elements, the ConfigFile itself is already further ahead
+  class Source : public ConfigSource
+  {
+  public:
+    explicit Source( const std::string& filename );
+    virtual void display_error( const std::string& msg, bool show_curline = true,
+                                const ConfigElemBase* elem = nullptr,
+                                bool error = true ) const override;
+    std::string filename;
+    unsigned line;
+  };
+
+  void parse();
+  bool push( Batch& batch );
+
+  ConfigFile _cf;
+  Source _source;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<Batch> _batches;
+  bool _finished;
+  bool _stop;
+  std::exception_ptr _error;
+  Tools::HighPerfTimer::time_mu _parse_time;
+  Tools::HighPerfTimer::time_mu _wait_time;
+  Batch _current;
+  size_t _pos;
+  std::thread _thread;
+};
+}  // namespace Clib
+}  // namespace Pol
+#endif
@@ -4,6 +4,10 @@ logging stuff
 basic idea is to have an extra thread which performs all the file operations
 the sinks are fixed defined which removes a bit the flexibility, but makes the code cleaner
 and new sinks can be easily added.
+the thread takes all queued messages at once and flushes the sinks after such a batch,
+file sinks only when their flush interval passed.
+if too many messages are queued, messages of sinks which allow it (script.log, debug.log,
+flex logs) get dropped and counted, for the others the caller waits.
 
 Usage:
 POLLOGLN("my text)"
@@ -12,11 +16,14 @@ POLLOG("hello {}\n", "world");
 
 #include "logfacility.h"
 
+#include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <fmt/chrono.h>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <list>
 #include <mutex>
 #include <string.h>
 #include <thread>
@@ -42,22 +49,28 @@ struct LogFileBehaviour
   bool rollover;
   std::ios_base::openmode openmode;
   bool timestamps;
+  std::chrono::milliseconds flush_interval;
 };
 
 // definitions of the logfile behaviours
-static LogFileBehaviour startlogBehaviour = { "log/start", false,
-                                              std::ios_base::out | std::ios_base::trunc, false };
-static LogFileBehaviour pollogBehaviour = { "log/pol", true,
-                                            std::ios_base::out | std::ios_base::app, true };
-static LogFileBehaviour debuglogBehaviour = { "log/debug", false,
-                                              std::ios_base::out | std::ios_base::app, false };
-static LogFileBehaviour scriptlogBehaviour = { "log/script", false,
-                                               std::ios_base::out | std::ios_base::app, false };
-static LogFileBehaviour leaklogBehaviour = { "log/leak", false,
-                                             std::ios_base::out | std::ios_base::app, false };
+static LogFileBehaviour startlogBehaviour = {
+    "log/start", false, std::ios_base::out | std::ios_base::trunc, false,
+    std::chrono::milliseconds( 0 ) };
+static LogFileBehaviour pollogBehaviour = {
+    "log/pol", true, std::ios_base::out | std::ios_base::app, true,
+    std::chrono::milliseconds( 0 ) };
+static LogFileBehaviour debuglogBehaviour = {
+    "log/debug", false, std::ios_base::out | std::ios_base::app, false,
+    std::chrono::milliseconds( 1000 ) };
+static LogFileBehaviour scriptlogBehaviour = {
+    "log/script", false, std::ios_base::out | std::ios_base::app, false,
+    std::chrono::milliseconds( 1000 ) };
+static LogFileBehaviour leaklogBehaviour = {
+    "log/leak", false, std::ios_base::out | std::ios_base::app, false,
+    std::chrono::milliseconds( 1000 ) };
 static LogFileBehaviour flexlogBehaviour = { "",  // dummy name
                                              false, std::ios_base::out | std::ios_base::app,
-                                             false };
+                                             false, std::chrono::milliseconds( 1000 ) };
 
 // due to a bug in VS a global cannot thread join in the deconstructor
 // thats why this is only a pointer and owned somewhere in main
@@ -78,9 +91,18 @@ class LogFacility::LogWorker
   typedef std::function<void()> msg;
   typedef message_queue<msg> msg_queue;
 
+  // limit of queued messages before they get dropped or the caller waits
+  static constexpr size_t max_queued = 100000;
+  // wake up interval without messages, the longest flush interval of the sinks
+  static constexpr std::chrono::milliseconds idle_interval{ 1000 };
+
 public:
   // run thread on construction
-  LogWorker() : _done( false ), _queue(), _work_thread() { run(); }
+  LogWorker( LogFacility* facility )
+      : _facility( facility ), _done( false ), _queued( 0 ), _dropped( 0 ), _queue(), _work_thread()
+  {
+    run();
+  }
   LogWorker( const LogWorker& ) = delete;
   LogWorker& operator=( const LogWorker& ) = delete;
   // on deconstruction send exit
@@ -98,7 +120,25 @@ public:
     _work_thread.join();  // wait for it
   }
   // send msg into queue
-  void send( const msg& msg_ ) { _queue.push( msg_ ); }
+  void send( msg&& msg_ )
+  {
+    ++_queued;
+    _queue.push_move( std::move( msg_ ) );
+  }
+  // false if a message has to be dropped, otherwise waits till the queue has room
+  bool reserve( bool drop )
+  {
+    while ( _queued.load( std::memory_order_relaxed ) >= max_queued )
+    {
+      if ( drop )
+      {
+        ++_dropped;
+        return false;
+      }
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return true;
+  }
 
 private:
   // endless loop in thread
@@ -107,28 +147,46 @@ private:
     _work_thread = std::thread(
         [&]()
         {
+          std::list<msg> batch;
           while ( !_done )
           {
             try
             {
-              msg func;
-              _queue.pop_wait( &func );
-              func();  // execute
+              _queue.pop_wait_for( &batch, idle_interval );
+              // counted off before executing, a throwing message discards the rest of the batch
+              _queued -= batch.size();
+              while ( !batch.empty() )
+              {
+                msg func = std::move( batch.front() );
+                batch.pop_front();
+                func();  // execute
+              }
+
+              if ( size_t dropped = _dropped.exchange( 0 ) )
+              {
+                getSink<LogSink_pollog>()->addMessage( fmt::format(
+                    "{} log messages dropped, too many messages were queued.\n", dropped ) );
+              }
+              _facility->flushSinks( _done );
             }
             catch ( std::exception& msg )
             {
+              batch.clear();
               std::cout << msg.what() << std::endl;
             }
           }
         } );
   }
+  LogFacility* _facility;
   bool _done;
+  std::atomic<size_t> _queued;
+  std::atomic<size_t> _dropped;
   msg_queue _queue;
   std::thread _work_thread;
 };
 
 
-LogFacility::LogFacility() : _worker( new LogWorker ) {}
+LogFacility::LogFacility() : _worker( new LogWorker( this ) ), _stderr_only( false ) {}
 
 // note this blocks till the worker is finished
 LogFacility::~LogFacility()
@@ -143,6 +201,13 @@ LogFacility::~LogFacility()
 template <typename Sink>
 void LogFacility::save( std::string message, std::string id )
 {
+  if ( _stderr_only )
+  {
+    std::fputs( message.c_str(), stderr );
+    return;
+  }
+  if ( !_worker->reserve( Sink::dropOnOverflow ) )
+    return;
   _worker->send(
       [msg = std::move( message ), id = std::move( id )]()
       {
@@ -163,6 +228,13 @@ void LogFacility::registerSink( LogSink* sink )
   _registered_sinks.push_back( sink );
 }
 
+// only called by the worker, like the registration of sinks
+void LogFacility::flushSinks( bool force )
+{
+  for ( auto& sink : _registered_sinks )
+    sink->flush( force );
+}
+
 // disables debuglog
 void LogFacility::disableDebugLog()
 {
@@ -212,10 +284,22 @@ void LogFacility::wait_for_empty_queue()
 {
   auto promise = std::make_shared<std::promise<bool>>();
   auto ret = promise->get_future();
-  _worker->send( [=]() { promise->set_value( true ); } );
+  _worker->send(
+      [=]()
+      {
+        flushSinks( true );
+        promise->set_value( true );
+      } );
   ret.get();  // block wait till valid
 }
 
+// for a forked child process which has no worker thread: every message is written directly to
+// stderr, nothing is queued anymore
+void LogFacility::writeToStderr()
+{
+  _stderr_only = true;
+}
+
 template <typename Sink>
 void Message<Sink>::send( std::string msg, std::string id )
 {
@@ -243,14 +327,21 @@ LogSinkGenericFile::LogSinkGenericFile( const LogFileBehaviour* behaviour )
     : LogSink(),
       _behaviour( behaviour ),
       _log_filename( behaviour->basename + ".log" ),
-      _active_line( false )
+      _lastflush(),
+      _active_line( false ),
+      _unflushed( false )
 {
   memset( &_opened, 0, sizeof( _opened ) );
   open_log_file( true );
 }
 // default constructor does not open directly
 LogSinkGenericFile::LogSinkGenericFile()
-    : LogSink(), _behaviour(), _log_filename(), _active_line( false )
+    : LogSink(),
+      _behaviour(),
+      _log_filename(),
+      _lastflush(),
+      _active_line( false ),
+      _unflushed( false )
 {
   memset( &_opened, 0, sizeof( _opened ) );
 }
@@ -322,13 +413,26 @@ void LogSinkGenericFile::addMessage( const std::string& msg )
   }
   _active_line = ( msg.back() != '\n' );  // is the last character a newline?
   _filestream << msg;
-  _filestream.flush();
+  _unflushed = true;
 }
 void LogSinkGenericFile::addMessage( const std::string& msg, const std::string& )
 {
   addMessage( msg );
 }
 
+// flush the filestream if the interval passed since the last flush
+void LogSinkGenericFile::flush( bool force )
+{
+  if ( !_unflushed || !_filestream.is_open() )
+    return;
+  auto now = std::chrono::steady_clock::now();
+  if ( !force && now - _lastflush < _behaviour->flush_interval )
+    return;
+  _filestream.flush();
+  _lastflush = now;
+  _unflushed = false;
+}
+
 // check if a rollover is needed (new day)
 bool LogSinkGenericFile::test_for_rollover(
     std::chrono::time_point<std::chrono::system_clock>& now )
@@ -359,7 +463,6 @@ LogSink_cout::LogSink_cout() : LogSink() {}
 void LogSink_cout::addMessage( const std::string& msg )
 {
   std::cout << msg;
-  std::cout.flush();
 #if defined( WINDOWS )
   if ( LogFacility::_vsDebuggerPresent )
     OutputDebugString( msg.c_str() );
@@ -369,13 +472,16 @@ void LogSink_cout::addMessage( const std::string& msg, const std::string& )
 {
   addMessage( msg );
 }
+void LogSink_cout::flush( bool )
+{
+  std::cout.flush();
+}
 
 LogSink_cerr::LogSink_cerr() : LogSink() {}
 // print given msg into std::cerr
 void LogSink_cerr::addMessage( const std::string& msg )
 {
   std::cerr << msg;
-  std::cerr.flush();
 #if defined( WINDOWS )
   if ( LogFacility::_vsDebuggerPresent )
     OutputDebugString( msg.c_str() );
@@ -385,6 +491,10 @@ void LogSink_cerr::addMessage( const std::string& msg, const std::string& )
 {
   addMessage( msg );
 }
+void LogSink_cerr::flush( bool )
+{
+  std::cerr.flush();
+}
 
 // on construction this opens not pol.log instead start.log
 LogSink_pollog::LogSink_pollog() : LogSinkGenericFile( &startlogBehaviour ) {}
@@ -457,6 +567,11 @@ void LogSink_flexlog::addMessage( const std::string& /*msg*/ )
 {
   // empty
 }
+void LogSink_flexlog::flush( bool force )
+{
+  for ( auto& logfile : _logfiles )
+    logfile.second->flush( force );
+}
 
 // closes logfile of given id
 void LogSink_flexlog::close( const std::string& id )
@@ -41,6 +41,7 @@ public:
   void setBehaviour( const LogFileBehaviour* behaviour, std::string filename );
   virtual void addMessage( const std::string& msg ) override;
   virtual void addMessage( const std::string& msg, const std::string& id ) override;
+  virtual void flush( bool force ) override;
 
 protected:
   friend class LogFacility;
@@ -51,7 +52,9 @@ protected:
   std::string _log_filename;
   struct tm _opened;
   std::chrono::time_point<std::chrono::system_clock> _lasttimestamp;
+  std::chrono::steady_clock::time_point _lastflush;
   bool _active_line;
+  bool _unflushed;
   static bool _disabled;
 };
 
@@ -67,6 +70,7 @@ public:
   virtual ~LogSink_cout() = default;
   virtual void addMessage( const std::string& msg ) override;
   virtual void addMessage( const std::string& msg, const std::string& id ) override;
+  virtual void flush( bool force ) override;
 };
 
 // std::cerr sink
@@ -77,6 +81,7 @@ public:
   virtual ~LogSink_cerr() = default;
   virtual void addMessage( const std::string& msg ) override;
   virtual void addMessage( const std::string& msg, const std::string& id ) override;
+  virtual void flush( bool force ) override;
 };
 
 // pol.log (and start.log) file sink
@@ -94,6 +99,7 @@ class LogSink_scriptlog final : public LogSinkGenericFile
 public:
   LogSink_scriptlog();
   virtual ~LogSink_scriptlog() = default;
+  static constexpr bool dropOnOverflow = true;
 };
 
 // debug.log file sink
@@ -106,6 +112,7 @@ public:
   virtual void addMessage( const std::string& msg, const std::string& id ) override;
   void disable();
   static bool Disabled;
+  static constexpr bool dropOnOverflow = true;
 };
 
 // leak.log file sink
@@ -124,7 +131,9 @@ public:
   std::string create( std::string logfilename, bool open_timestamp );
   virtual void addMessage( const std::string& msg ) override;
   virtual void addMessage( const std::string& msg, const std::string& id ) override;
+  virtual void flush( bool force ) override;
   void close( const std::string& id );
+  static constexpr bool dropOnOverflow = true;
 
 private:
   std::map<std::string, std::shared_ptr<LogSinkGenericFile>> _logfiles;
@@ -138,6 +147,7 @@ public:
   virtual ~LogSink_dual() = default;
   virtual void addMessage( const std::string& msg ) override;
   virtual void addMessage( const std::string& msg, const std::string& id ) override;
+  static constexpr bool dropOnOverflow = log1::dropOnOverflow && log2::dropOnOverflow;
 };
 
 // main class which starts the logging
@@ -157,13 +167,16 @@ public:
   void closeFlexLog( const std::string& id );
   std::string registerFlexLogger( const std::string& logfilename, bool open_timestamp );
   void wait_for_empty_queue();
+  void writeToStderr();
 
   static bool _vsDebuggerPresent;
 
 private:
   class LogWorker;
+  void flushSinks( bool force );
   std::unique_ptr<LogWorker> _worker;
   std::vector<LogSink*> _registered_sinks;
+  bool _stderr_only;
 };
 
 // macro struct for logging entrypoint
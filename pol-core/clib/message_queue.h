@@ -43,6 +43,8 @@ public:
   void pop_wait( Message* msg );
   // waits till queue is non empty and fill list
   void pop_wait( std::list<Message>* msgs );
+  // waits till queue is non empty or the timeout passed and fill list
+  void pop_wait_for( std::list<Message>* msgs, std::chrono::milliseconds timeout );
   // empties the queue (unsafe)
   void pop_remaining( std::list<Message>* msgs );
 
@@ -161,6 +163,17 @@ void message_queue<Message>::pop_wait( std::list<Message>* msgs )
   msgs->splice( msgs->end(), _queue );
 }
 
+template <typename Message>
+void message_queue<Message>::pop_wait_for( std::list<Message>* msgs,
+                                           std::chrono::milliseconds timeout )
+{
+  std::unique_lock<std::mutex> lock( _mutex );
+  _notifier.wait_for( lock, timeout, [&]() { return !_queue.empty() || _cancel; } );
+  if ( _cancel )
+    throw Canceled();
+  msgs->splice( msgs->end(), _queue );
+}
+
 template <typename Message>
 void message_queue<Message>::pop_remaining( std::list<Message>* msgs )
 {
@@ -149,8 +149,8 @@ size_t memsize( const std::vector<T>& container, Func f )
   return size;
 }
 
-template <typename T>
-size_t memsize( const std::set<T>& container )
+template <typename T, typename C>
+size_t memsize( const std::set<T, C>& container )
 {
   if constexpr ( std::is_same_v<T, std::string> )
   {
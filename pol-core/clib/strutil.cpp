@@ -31,26 +31,27 @@ void splitnamevalue( const std::string& istr, std::string& propname, std::string
     {
       std::string::size_type valuestart = istr.find_first_not_of( " \t\r\n", delimpos + 1 );
       std::string::size_type valueend = istr.find_last_not_of( " \t\r\n" );
-      propname = istr.substr( start, delimpos - start );
+      // assign instead of substr, the callers reuse their buffers for every line
+      propname.assign( istr, start, delimpos - start );
       if ( valuestart != std::string::npos && valueend != std::string::npos )
       {
-        propvalue = istr.substr( valuestart, valueend - valuestart + 1 );
+        propvalue.assign( istr, valuestart, valueend - valuestart + 1 );
       }
       else
       {
-        propvalue = "";
+        propvalue.clear();
       }
     }
     else
     {
-      propname = istr.substr( start, std::string::npos );
-      propvalue = "";
+      propname.assign( istr, start, std::string::npos );
+      propvalue.clear();
     }
   }
   else
   {
-    propname = "";
-    propvalue = "";
+    propname.clear();
+    propvalue.clear();
   }
 }
 
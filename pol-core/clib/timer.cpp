@@ -1,5 +1,8 @@
 #include "timer.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "logfacility.h"
 
 namespace Pol
@@ -72,6 +75,87 @@ HighPerfTimer::time_mu HighPerfTimer::ellapsed() const
   return std::chrono::duration_cast<time_mu>( _now - _start );
 }
 
+LatencyHistogram::LatencyHistogram() : _buckets(), _sum_mu( 0 )
+{
+  reset();
+}
+
+void LatencyHistogram::record( time_mu duration )
+{
+  const u64 mu = static_cast<u64>( std::max<time_mu::rep>( 0, duration.count() ) );
+  const auto bucket = std::lower_bound( BucketBounds.begin(), BucketBounds.end(), mu );
+  _buckets[std::distance( BucketBounds.begin(), bucket )].fetch_add( 1,
+                                                                     std::memory_order_relaxed );
+  _sum_mu.fetch_add( mu, std::memory_order_relaxed );
+}
+
+void LatencyHistogram::reset()
+{
+  for ( auto& bucket : _buckets )
+    bucket.store( 0, std::memory_order_relaxed );
+  _sum_mu.store( 0, std::memory_order_relaxed );
+}
+
+u64 LatencyHistogram::count() const
+{
+  u64 count = 0;
+  for ( const auto& bucket : _buckets )
+    count += bucket.load( std::memory_order_relaxed );
+  return count;
+}
+
+LatencyHistogram::time_mu LatencyHistogram::quantile( double q ) const
+{
+  std::array<u64, BucketBounds.size() + 1> counts;
+  u64 total = 0;
+  for ( size_t i = 0; i < counts.size(); ++i )
+    total += counts[i] = _buckets[i].load( std::memory_order_relaxed );
+  if ( !total )
+    return time_mu( 0 );
+
+  const double rank = std::clamp( q, 0.0, 1.0 ) * total;
+  u64 seen = 0;
+  for ( size_t i = 0; i < counts.size(); ++i )
+  {
+    if ( !counts[i] || seen + counts[i] < rank )
+    {
+      seen += counts[i];
+      continue;
+    }
+    // nothing is known above the last bound, report the bound itself
+    if ( i == BucketBounds.size() )
+      return time_mu( BucketBounds.back() );
+    const double lower = i ? static_cast<double>( BucketBounds[i - 1] ) : 0.0;
+    const double upper = static_cast<double>( BucketBounds[i] );
+    return time_mu(
+        static_cast<time_mu::rep>( lower + ( upper - lower ) * ( rank - seen ) / counts[i] ) );
+  }
+  return time_mu( BucketBounds.back() );
+}
+
+void LatencyHistogram::write_prometheus( std::string& out, const std::string& name,
+                                         const std::string& help ) const
+{
+  auto it = std::back_inserter( out );
+  fmt::format_to( it,
+                  "# HELP {0}_seconds {1}\n"
+                  "# TYPE {0}_seconds histogram\n",
+                  name, help );
+  u64 cumulative = 0;
+  for ( size_t i = 0; i < BucketBounds.size(); ++i )
+  {
+    cumulative += _buckets[i].load( std::memory_order_relaxed );
+    fmt::format_to( it, "{}_seconds_bucket{{le=\"{}\"}} {}\n", name, BucketBounds[i] / 1e6,
+                    cumulative );
+  }
+  cumulative += _buckets.back().load( std::memory_order_relaxed );
+  fmt::format_to( it,
+                  "{0}_seconds_bucket{{le=\"+Inf\"}} {1}\n"
+                  "{0}_seconds_sum {2}\n"
+                  "{0}_seconds_count {1}\n",
+                  name, cumulative, _sum_mu.load( std::memory_order_relaxed ) / 1e6 );
+}
+
 // forward declarce both versions
 template class Timer<DebugT>;
 template class Timer<SilentT>;
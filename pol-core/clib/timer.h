@@ -1,9 +1,13 @@
 #ifndef CLIB_TIMER_H
 #define CLIB_TIMER_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <string>
 
+#include "rawtypes.h"
+
 namespace Pol
 {
 namespace Tools  // global ns is enough polluted
@@ -60,6 +64,52 @@ public:
 private:
   Clock::time_point _start;
 };
+
+// lock-free latency histogram with fixed buckets from 10us to 10s in 1-2-5 steps
+// record can be called from any thread, readers get a slightly fuzzy snapshot
+class LatencyHistogram
+{
+public:
+  typedef std::chrono::microseconds time_mu;
+  static constexpr std::array<u64, 19> BucketBounds = {
+      10,     20,     50,     100,     200,     500,     1000,    2000,    5000,   10000,
+      20000,  50000,  100000, 200000,  500000,  1000000, 2000000, 5000000, 10000000 };
+
+  LatencyHistogram();
+  void record( time_mu duration );
+  void reset();
+  u64 count() const;
+  // estimated by linear interpolation inside the bucket, q in [0,1]
+  time_mu quantile( double q ) const;
+  // prometheus text exposition format, name gets the suffix _seconds
+  void write_prometheus( std::string& out, const std::string& name,
+                         const std::string& help ) const;
+
+private:
+  std::array<std::atomic<u64>, BucketBounds.size() + 1> _buckets;  // last is +Inf
+  std::atomic<u64> _sum_mu;
+};
+
+// records the lifetime into the given histogram
+class LatencyTimer
+{
+public:
+  explicit LatencyTimer( LatencyHistogram& histogram )
+      : _histogram( histogram ), _start( HighPerfTimer::Clock::now() )
+  {
+  }
+  ~LatencyTimer()
+  {
+    _histogram.record( std::chrono::duration_cast<LatencyHistogram::time_mu>(
+        HighPerfTimer::Clock::now() - _start ) );
+  }
+  LatencyTimer( const LatencyTimer& ) = delete;
+  LatencyTimer& operator=( const LatencyTimer& ) = delete;
+
+private:
+  LatencyHistogram& _histogram;
+  HighPerfTimer::Clock::time_point _start;
+};
 }
 }
 
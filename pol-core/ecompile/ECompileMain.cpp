@@ -242,6 +242,41 @@ bool format_file( const char* path )
   return true;
 }
 
+// .dep files list one dependency per line, followed by a tab and the hash of its contents
+std::string dependency_name( const std::string& line )
+{
+  return line.substr( 0, line.find( '\t' ) );
+}
+
+/**
+ * Checks the contents of all dependencies against the hashes of the last successful compile
+ *
+ * @return TRUE if every dependency still has the recorded hash
+ */
+bool dependency_hashes_match( const std::string& filename_dep )
+{
+  std::ifstream ifs( filename_dep.c_str() );
+  if ( !ifs.is_open() )
+    return false;
+  std::string line;
+  bool any = false;
+  while ( getline( ifs, line ) )
+  {
+    auto tab = line.find( '\t' );
+    if ( tab == std::string::npos )
+      return false;
+    auto hash = Compiler::Compiler::content_hash( line.substr( 0, tab ) );
+    if ( hash.empty() || line.compare( tab + 1, std::string::npos, hash ) != 0 )
+    {
+      if ( compilercfg.VerbosityLevel > 0 )
+        INFO_PRINTLN( "{} has changed", line.substr( 0, tab ) );
+      return false;
+    }
+    any = true;
+  }
+  return any;
+}
+
 void add_dependency_info( const fs::path& filepath_src,
                           std::set<fs::path>* removed_dependencies = nullptr,
                           std::set<fs::path>* new_dependencies = nullptr )
@@ -273,10 +308,10 @@ void add_dependency_info( const fs::path& filepath_src,
     std::ifstream ifs( filename_dep.c_str() );
     if ( ifs.is_open() )
     {
-      std::string depname;
-      while ( getline( ifs, depname ) )
+      std::string line;
+      while ( getline( ifs, line ) )
       {
-        fs::path depnamepath = fs::canonical( fs::path( depname ) );
+        fs::path depnamepath = fs::canonical( fs::path( dependency_name( line ) ) );
         auto& owners = dependency_owners[depnamepath];
         // Add this source as a dependency by:
         // (1) placing `filename_src` in the set of owners for `depnamepath`.
@@ -366,9 +401,10 @@ bool compile_file( const char* path )
       // if the file doesn't exist, gotta build.
       if ( ifs.is_open() )
       {
-        std::string depname;
-        while ( getline( ifs, depname ) )
+        std::string line;
+        while ( getline( ifs, line ) )
         {
+          auto depname = dependency_name( line );
           if ( Clib::GetFileTimestamp( depname.c_str() ) >= ecl_timestamp )
           {
             if ( compilercfg.VerbosityLevel > 0 )
@@ -385,6 +421,22 @@ bool compile_file( const char* path )
         all_old = false;
       }
     }
+    // a newer timestamp alone (checkout, copied scripts) doesn't need a compile when the contents
+    // are still the same as the last time
+    if ( !all_old && ecl_timestamp )
+    {
+      if ( dependency_hashes_match( filename_dep ) )
+      {
+        ++summary.profile.dependency_hash_hits;
+        std::error_code ec;
+        fs::last_write_time( filename_ecl, fs::file_time_type::clock::now(), ec );
+        all_old = true;
+      }
+      else
+      {
+        ++summary.profile.dependency_hash_misses;
+      }
+    }
     if ( all_old )
     {
       if ( !quiet && compilercfg.DisplayUpToDateScripts )
@@ -878,6 +930,8 @@ void DisplaySummary( const Tools::Timer<>& timer )
     tmp += fmt::format( "      - ambiguities: {}\n", (long)summary.profile.ambiguities );
     tmp += fmt::format( "       - cache hits: {}\n", (long)summary.profile.cache_hits );
     tmp += fmt::format( "     - cache misses: {}\n", (long)summary.profile.cache_misses );
+    tmp += fmt::format( "    - dep hash hits: {}\n", (long)summary.profile.dependency_hash_hits );
+    tmp += fmt::format( "  - dep hash misses: {}\n", (long)summary.profile.dependency_hash_misses );
   }
 
   INFO_PRINTLN( tmp );
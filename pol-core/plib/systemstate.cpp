@@ -17,7 +17,7 @@ SystemState::SystemState()
     : packages(),
       packages_byname(),
       accounts_txt_dirty( false ),
-      accounts_txt_stat(),
+      accounts_txt_stamp( 0 ),
       config(),
       tile(),
       max_graphic( 0 )
@@ -37,7 +37,7 @@ public:
   PackagesByName packages_byname;
 
   bool accounts_txt_dirty;
-  struct stat accounts_txt_stat;
+  unsigned int accounts_txt_stamp;
 
   Core::PolConfig config;
   std::vector<Tile> tile;
@@ -253,7 +253,8 @@ set (pol_sources  # sorted !
   network/clienttransmit.h
   network/cliface.cpp
   network/cliface.h
-  network/iostats.cpp
+  network/gumpcache.cpp
+  network/gumpcache.h
   network/iostats.h
   network/msgfiltr.cpp
   network/msgfiltr.h
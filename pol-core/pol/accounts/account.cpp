@@ -35,7 +35,8 @@ Account::Account( Clib::ConfigElem& elem )
       enabled_( true ),
       banned_( false ),
       props_( Core::CPropProfiler::Type::ACCOUNT ),
-      default_cmdlevel_( 0 )
+      default_cmdlevel_( 0 ),
+      dirty_( false )
 {
   // If too low, will cause the client to freeze and the console to report
   // Exception in message handler 0x91: vector
@@ -57,6 +58,7 @@ void Account::readfrom( Clib::ConfigElem& elem )
     if ( !Clib::MD5_Encrypt( name_ + temppass, passwordhash_ ) )  // MD5
       elem.throw_error( "Failed to encrypt password for " + name_ );
     Plib::systemstate.accounts_txt_dirty = true;
+    dirty_ = true;
   }
   else if ( elem.has_prop( "PasswordHash" ) )
   {
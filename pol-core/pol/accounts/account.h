@@ -59,8 +59,20 @@ public:
   std::string default_privlist() const;
   unsigned char default_cmdlevel() const;
 
-  void set_password( std::string newpass ) { password_ = newpass; };
-  void set_passwordhash( std::string newpass ) { passwordhash_ = newpass; };
+  void set_password( std::string newpass )
+  {
+    password_ = newpass;
+    dirty_ = true;
+  };
+  void set_passwordhash( std::string newpass )
+  {
+    passwordhash_ = newpass;
+    dirty_ = true;
+  };
+
+  // changed since the account was last written
+  bool dirty() const { return dirty_; }
+  void set_dirty( bool dirty ) { dirty_ = dirty; }
   friend class AccountObjImp;
 
 private:
@@ -76,6 +88,7 @@ private:
   unsigned char default_cmdlevel_;
 
   Clib::StringSet options_;
+  bool dirty_;
 };
 }
 }
@@ -11,15 +11,18 @@
 #include "accounts.h"
 
 #include <iosfwd>
+#include <set>
 #include <stdio.h>
 #include <string.h>
-#include <sys/stat.h>
 #include <time.h>
+#include <vector>
 
 #include "../../clib/cfgelem.h"
 #include "../../clib/cfgfile.h"
 #include "../../clib/clib.h"
+#include "../../clib/fileutil.h"
 #include "../../clib/logfacility.h"
+#include "../../clib/maputil.h"
 #include "../../clib/passert.h"
 #include "../../clib/streamsaver.h"
 #include "../../clib/timer.h"
@@ -33,16 +36,168 @@ namespace Pol
 {
 namespace Accounts
 {
+namespace
+{
+// smaller account lists are always written completely
+const size_t delta_min_accounts = 1000;
+
+// Changes are appended to accounts.delta.txt: a Base element identifying the accounts.txt it
+// belongs to, followed by blocks of Account and Deleted elements, each closed by a Commit.
+// accounts.txt is rewritten once the deltas hold as many accounts as half of it.
+struct AccountDeltas
+{
+  std::set<std::string, Clib::ci_cmp_pred> released_names;
+  size_t accounts = 0;  // account records in the delta file
+  unsigned commits = 0;
+  bool full_save_needed = false;
+};
+AccountDeltas deltas;
+
+std::string accounts_txt_file()
+{
+  return Plib::systemstate.config.world_data_path + "accounts.txt";
+}
+
+std::string accounts_delta_file()
+{
+  return Plib::systemstate.config.world_data_path + "accounts.delta.txt";
+}
+
+void remove_account( const std::string& name )
+{
+  for ( auto itr = Core::gamestate.accounts.begin(), end = Core::gamestate.accounts.end();
+        itr != end; ++itr )
+  {
+    if ( stricmp( ( *itr )->name(), name.c_str() ) == 0 )
+    {
+      if ( ( *itr )->numchars() == 0 )
+        Core::gamestate.accounts.erase( itr );
+      return;
+    }
+  }
+}
+
+void reread_account( Clib::ConfigElem& elem );
+
+// applies the committed blocks of accounts.delta.txt, check_base is false when accounts.txt got
+// edited while the server is running
+void read_account_deltas( bool check_base )
+{
+  std::string deltafile = accounts_delta_file();
+  if ( !Clib::FileExists( deltafile ) )
+    return;
+
+  bool belongs_to_base = true;
+  {
+    Clib::ConfigFile cf( deltafile, "Base Account Deleted Commit" );
+    Clib::ConfigElem elem;
+    if ( !cf.read( elem ) || !elem.type_is( "Base" ) )
+    {
+      POLLOG_ERRORLN( "{} doesn't start with a Base element, ignored.", deltafile );
+      deltas.full_save_needed = Plib::systemstate.accounts_txt_dirty = true;
+      return;
+    }
+    std::string txtfile = accounts_txt_file();
+    if ( check_base )
+    {
+      belongs_to_base =
+          elem.remove_ulong( "Modified" ) == Clib::GetFileTimestamp( txtfile.c_str() ) &&
+          elem.remove_int( "Size" ) == Clib::filesize( txtfile.c_str() );
+    }
+
+    std::vector<Clib::ConfigElem> pending;
+    while ( belongs_to_base && cf.read( elem ) )
+    {
+      if ( elem.type_is( "Commit" ) )
+      {
+        for ( auto& change : pending )
+        {
+          if ( change.type_is( "Deleted" ) )
+            remove_account( change.remove_string( "Name" ) );
+          else
+            reread_account( change );
+        }
+        deltas.accounts += pending.size();
+        ++deltas.commits;
+        pending.clear();
+      }
+      else
+      {
+        pending.push_back( elem );
+      }
+    }
+    if ( !pending.empty() )
+    {
+      // written by a save that never finished, nothing may be appended after it
+      deltas.full_save_needed = Plib::systemstate.accounts_txt_dirty = true;
+    }
+  }
+
+  if ( !belongs_to_base )
+  {
+    // either left behind by a crash during a complete write, or accounts.txt was edited offline
+    std::string bakfile = Plib::systemstate.config.world_data_path + "accounts.delta.bak";
+    POLLOG_ERRORLN( "{} doesn't belong to {}, ignored and kept as {}.", deltafile,
+                    accounts_txt_file(), bakfile );
+    Clib::RemoveFile( bakfile );
+    rename( deltafile.c_str(), bakfile.c_str() );
+    deltas.full_save_needed = Plib::systemstate.accounts_txt_dirty = true;
+  }
+}
+
+bool write_account_deltas()
+{
+  std::string deltafile = accounts_delta_file();
+  // the first delta after a complete write replaces the file
+  std::ofstream ofs( deltafile.c_str(), deltas.commits ? std::ios::app | std::ios::out
+                                                       : std::ios::trunc | std::ios::out );
+  {
+    Clib::StreamWriter sw( &ofs );
+    if ( !deltas.commits )
+    {
+      std::string txtfile = accounts_txt_file();
+      sw.begin( "Base" );
+      sw.add( "Modified", Clib::GetFileTimestamp( txtfile.c_str() ) );
+      sw.add( "Size", Clib::filesize( txtfile.c_str() ) );
+      sw.end();
+    }
+    for ( const auto& name : deltas.released_names )
+    {
+      sw.begin( "Deleted" );
+      sw.add( "Name", name );
+      sw.end();
+    }
+    for ( const auto& account : Core::gamestate.accounts )
+    {
+      if ( account->dirty() )
+        account->writeto( sw );
+    }
+    sw.begin( "Commit" );
+    sw.end();
+  }
+  ofs.close();
+  return !ofs.fail();
+}
+
+void clear_account_changes()
+{
+  for ( const auto& account : Core::gamestate.accounts )
+    account->set_dirty( false );
+  deltas.released_names.clear();
+  Plib::systemstate.accounts_txt_dirty = false;
+}
+}  // namespace
+
 void read_account_data()
 {
   unsigned int naccounts = 0;
   static int num_until_dot = 1000;
   Tools::Timer<> timer;
 
-  std::string accountsfile = Plib::systemstate.config.world_data_path + "accounts.txt";
+  std::string accountsfile = accounts_txt_file();
 
   INFO_PRINT( "  {}:", accountsfile );
-  stat( accountsfile.c_str(), &Plib::systemstate.accounts_txt_stat );
+  Plib::systemstate.accounts_txt_stamp = Clib::GetFileTimestamp( accountsfile.c_str() );
 
   {
     Clib::ConfigFile cf( accountsfile, "Account" );
@@ -59,6 +214,7 @@ void read_account_data()
       naccounts++;
     }
   }
+  read_account_deltas( true );
 
   if ( Plib::systemstate.accounts_txt_dirty )
   {
@@ -70,7 +226,28 @@ void read_account_data()
 
 void write_account_data()
 {
-  std::string accountstxtfile = Plib::systemstate.config.world_data_path + "accounts.txt";
+  size_t changed = deltas.released_names.size();
+  for ( const auto& account : Core::gamestate.accounts )
+  {
+    if ( account->dirty() )
+      ++changed;
+  }
+  size_t count = Core::gamestate.accounts.size();
+  if ( !deltas.full_save_needed && count >= delta_min_accounts &&
+       deltas.accounts + changed <= count / 2 )
+  {
+    if ( write_account_deltas() )
+    {
+      deltas.accounts += changed;
+      ++deltas.commits;
+      clear_account_changes();
+      return;
+    }
+    POLLOG_ERRORLN( "failed to store account changes, writing all accounts." );
+    deltas.full_save_needed = true;
+  }
+
+  std::string accountstxtfile = accounts_txt_file();
   std::string accountsbakfile = Plib::systemstate.config.world_data_path + "accounts.bak";
   std::string accountsndtfile = Plib::systemstate.config.world_data_path + "accounts.ndt";
   const char* accountstxtfile_c = accountstxtfile.c_str();
@@ -101,12 +278,25 @@ void write_account_data()
     return;
   rename( accountstxtfile_c, accountsbakfile_c );
   rename( accountsndtfile_c, accountstxtfile_c );
+  Clib::RemoveFile( accounts_delta_file() );
 
-  struct stat newst;
-  stat( accountstxtfile_c, &newst );
-  memcpy( &Plib::systemstate.accounts_txt_stat, &newst,
-          sizeof Plib::systemstate.accounts_txt_stat );
-  Plib::systemstate.accounts_txt_dirty = false;
+  Plib::systemstate.accounts_txt_stamp = Clib::GetFileTimestamp( accountstxtfile_c );
+  deltas = AccountDeltas();
+  clear_account_changes();
+}
+
+void account_changed( Account* acct )
+{
+  acct->set_dirty( true );
+  if ( Plib::systemstate.config.account_save == -1 )
+    write_account_data();
+  else
+    Plib::systemstate.accounts_txt_dirty = true;
+}
+
+void account_name_released( const std::string& name )
+{
+  deltas.released_names.insert( name );
 }
 
 Account* create_new_account( const std::string& acctname, const std::string& password,
@@ -121,10 +311,7 @@ Account* create_new_account( const std::string& acctname, const std::string& pas
   elem.add_prop( "enabled", ( (unsigned int)( enabled ? 1 : 0 ) ) );
   auto acct = new Account( elem );
   Core::gamestate.accounts.push_back( Core::AccountRef( acct ) );
-  if ( Plib::systemstate.config.account_save == -1 )
-    write_account_data();
-  else
-    Plib::systemstate.accounts_txt_dirty = true;
+  account_changed( acct );
   return acct;
 }
 
@@ -142,10 +329,7 @@ Account* duplicate_account( const std::string& oldacctname, const std::string& n
 
     auto acct = new Account( elem );
     Core::gamestate.accounts.push_back( Core::AccountRef( acct ) );
-    if ( Plib::systemstate.config.account_save == -1 )
-      write_account_data();
-    else
-      Plib::systemstate.accounts_txt_dirty = true;
+    account_changed( acct );
     return acct;
   }
   return nullptr;
@@ -173,6 +357,7 @@ int delete_account( const char* acctname )
     {
       if ( account->numchars() == 0 )
       {
+        deltas.released_names.insert( account->name() );
         Core::gamestate.accounts.erase( itr );
         if ( Plib::systemstate.config.account_save == -1 )
           write_account_data();
@@ -187,6 +372,8 @@ int delete_account( const char* acctname )
   return -2;
 }
 
+namespace
+{
 void reread_account( Clib::ConfigElem& elem )
 {
   std::string name = elem.remove_string( "NAME" );
@@ -201,22 +388,21 @@ void reread_account( Clib::ConfigElem& elem )
     Core::gamestate.accounts.push_back( Core::AccountRef( new Account( elem ) ) );
   }
 }
+}  // namespace
 
 void reload_account_data( void )
 {
   THREAD_CHECKPOINT( tasks, 500 );
   try
   {
-    std::string accountsfile = Plib::systemstate.config.world_data_path + "accounts.txt";
-
-    struct stat newst;
-    stat( accountsfile.c_str(), &newst );
-    if ( ( newst.st_mtime != Plib::systemstate.accounts_txt_stat.st_mtime ) &&
-         ( newst.st_mtime < time( nullptr ) - 10 ) )
+    // only a single stat, changes of the server itself go to accounts.delta.txt
+    std::string accountsfile = accounts_txt_file();
+    unsigned int stamp = Clib::GetFileTimestamp( accountsfile.c_str() );
+    if ( ( stamp != Plib::systemstate.accounts_txt_stamp ) &&
+         ( stamp < static_cast<unsigned int>( time( nullptr ) - 10 ) ) )
     {
       INFO_PRINT( "Reloading accounts.txt..." );
-      memcpy( &Plib::systemstate.accounts_txt_stat, &newst,
-              sizeof Plib::systemstate.accounts_txt_stat );
+      Plib::systemstate.accounts_txt_stamp = stamp;
 
       {
         Clib::ConfigFile cf( accountsfile, "Account" );
@@ -227,10 +413,11 @@ void reload_account_data( void )
         }
         INFO_PRINTLN( "Done!" );
       }
-      if ( Plib::systemstate.accounts_txt_dirty )
-      {
-        write_account_data();
-      }
+      // the deltas are newer than the edited file, afterwards everything is written anew
+      deltas = AccountDeltas();
+      read_account_deltas( false );
+      deltas.full_save_needed = true;
+      write_account_data();
     }
   }
   catch ( ... )
@@ -23,6 +23,10 @@ Account* create_new_account( const std::string& acctname, const std::string& pas
 Account* duplicate_account( const std::string& oldacctname, const std::string& newacctname );
 Account* find_account( const char* acctname );
 int delete_account( const char* acctname );
+// stores the change of acct, immediately if AccountDataSave is -1
+void account_changed( Account* acct );
+// the account named name got renamed, the next write has to drop the old record
+void account_name_released( const std::string& name );
 void write_account_data();
 void reload_account_data();
 void write_account_data_task();
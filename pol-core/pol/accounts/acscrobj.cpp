@@ -241,6 +241,7 @@ Bscript::BObjectImp* AccountObjImp::call_polmethod_id( const int id, Core::UOExe
           return new BError( "Account name must not be empty." );
         std::string temp;
         // passing the new name, and recalc name+pass hash (pass only hash is unchanged)
+        account_name_released( obj_->name_ );
         obj_->name_ = nmstr->value();
         Clib::MD5_Encrypt( obj_->name_ + obj_->password_, temp );
         obj_->passwordhash_ = temp;  // MD5
@@ -259,6 +260,7 @@ Bscript::BObjectImp* AccountObjImp::call_polmethod_id( const int id, Core::UOExe
       {
         if ( nmstr->value().empty() )
           return new BError( "Account name must not be empty." );
+        account_name_released( obj_->name_ );
         obj_->name_ = nmstr->value();
         // this is the same as the "setpassword" code above
         if ( Plib::systemstate.config.retain_cleartext_passwords )
@@ -537,10 +539,7 @@ Bscript::BObjectImp* AccountObjImp::call_polmethod_id( const int id, Core::UOExe
   }
 
   // if any of the methods hit & worked, we'll come here
-  if ( Plib::systemstate.config.account_save == -1 )
-    write_account_data();
-  else
-    Plib::systemstate.accounts_txt_dirty = true;
+  account_changed( obj_.Ptr() );
   return result ? result : new BLong( 1 );
 }
 
@@ -35,6 +35,7 @@
 #include "../clib/stlutil.h"
 #include "../clib/streamsaver.h"
 #include "../plib/uconst.h"
+#include "fnsearch.h"
 #include "globals/state.h"
 #include "globals/uvars.h"
 #include "item/itemdesc.h"
@@ -341,6 +342,12 @@ void UContainer::extract( Contents& cnt )
     passert_always( 0 );  // TODO remove once found
   }
   contents_.swap( cnt );
+  // the items are no longer reachable through this container
+  for ( auto& item : cnt )
+  {
+    if ( item != nullptr )
+      item->container = nullptr;
+  }
   add_bulk( -static_cast<int>( held_item_count_ ), -static_cast<int>( held_weight_ ) );
 }
 
@@ -372,6 +379,10 @@ void UContainer::swap( UContainer& cont )
     passert_always( 0 );  // TODO remove once found
   }
   contents_.swap( cont.contents_ );
+  for ( auto& item : contents_ )
+    item->container = this;
+  for ( auto& item : cont.contents_ )
+    item->container = &cont;
 }
 
 Items::Item* UContainer::find_toplevel_polclass( unsigned int polclass ) const
@@ -516,12 +527,34 @@ unsigned int UContainer::find_sumof_objtype_noninuse( u32 objtype ) const
   return amt;
 }
 
+// collects in the order find_objtype_noninuse() would return them while consuming
+void UContainer::collect_objtype_noninuse( u32 objtype, std::vector<Items::Item*>& items ) const
+{
+  for ( const auto& item : contents_ )
+  {
+    if ( item && ( item->objtype_ == objtype ) && !item->inuse() )
+      items.push_back( item );
+  }
+  for ( const auto& item : contents_ )
+  {
+    if ( item && item->isa( UOBJ_CLASS::CLASS_CONTAINER ) && !item->inuse() )
+    {
+      UContainer* cont = static_cast<UContainer*>( item );
+      if ( !cont->locked() )
+        cont->collect_objtype_noninuse( objtype, items );
+    }
+  }
+}
+
 void UContainer::consume_sumof_objtype_noninuse( u32 objtype, unsigned int amount )
 {
-  while ( amount != 0 )
+  // a single walk instead of searching again for every consumed stack
+  std::vector<Items::Item*> items;
+  collect_objtype_noninuse( objtype, items );
+  for ( auto itr = items.begin(); amount != 0; ++itr )
   {
-    Items::Item* item = find_objtype_noninuse( objtype );
-    passert_always( item != nullptr );
+    passert_always( itr != items.end() );
+    Items::Item* item = *itr;
 
     unsigned short thisamt = item->getamount();
     if ( thisamt > amount )
@@ -595,89 +628,59 @@ void UContainer::remove( iterator itr )
   remove_bulk( item );
 }
 
-// FIXME this is depth-first.  Not sure I like that.
-UContainer* UContainer::find_container( u32 objserial ) const
+// Every item is in the objecthash, so the serial lookups don't search the contents. Instead the
+// item's chain of containers is followed up to this container, which is cheap even for bankboxes
+// with thousands of items in nested bags.
+
+// true if item is somewhere inside this container, check_locks requires the containers in
+// between to be unlocked like a search through the contents would
+bool UContainer::holds( const Items::Item* item, bool check_locks ) const
 {
-  for ( auto& item : contents_ )
+  for ( const UContainer* cont = item->container; cont != nullptr; cont = cont->container )
   {
-    if ( item && item->isa( UOBJ_CLASS::CLASS_CONTAINER ) )
-    {
-      UContainer* cont = static_cast<UContainer*>( item );
-      if ( cont->serial == objserial )
-        return cont;
-      cont = cont->find_container( objserial );
-      if ( cont != nullptr )
-        return cont;
-    }
+    if ( cont == this )
+      return true;
+    if ( check_locks && cont->locked() )
+      return false;
   }
-  return nullptr;
+  return false;
+}
+
+UContainer* UContainer::find_container( u32 objserial ) const
+{
+  Items::Item* item = system_find_item( objserial );
+  if ( item == nullptr || !item->isa( UOBJ_CLASS::CLASS_CONTAINER ) || !holds( item, false ) )
+    return nullptr;
+  return static_cast<UContainer*>( item );
 }
 
 Items::Item* UContainer::find( u32 objserial, iterator& where_in_container )
 {
-  for ( iterator itr = contents_.begin(); itr != contents_.end(); ++itr )
+  Items::Item* item = find( objserial );
+  if ( item != nullptr )
   {
-    Items::Item* item = *itr;
-    passert( item != nullptr );
-    if ( item != nullptr )
-    {
-      if ( item->serial == objserial )
-      {
-        where_in_container = itr;
-        return item;
-      }
-      if ( item->isa( UOBJ_CLASS::CLASS_CONTAINER ) )
-      {
-        UContainer* cont = static_cast<UContainer*>( item );
-        if ( !cont->locked() )
-        {
-          item = cont->find( objserial, where_in_container );
-          if ( item != nullptr )
-            return item;
-        }
-      }
-    }
+    Contents& contents = item->container->contents_;
+    where_in_container = std::find( contents.begin(), contents.end(), item );
+    if ( where_in_container == contents.end() )
+      return nullptr;
   }
-  return nullptr;
+  return item;
 }
 
 Items::Item* UContainer::find( u32 objserial ) const
 {
-  for ( const auto& item : contents_ )
-  {
-    passert( item != nullptr );
-    if ( item != nullptr )
-    {
-      if ( item->serial == objserial )
-        return item;
-
-      if ( item->isa( UOBJ_CLASS::CLASS_CONTAINER ) )
-      {
-        UContainer* cont = static_cast<UContainer*>( item );
-        if ( !cont->locked() )
-        {
-          auto child_item = cont->find( objserial );
-          if ( child_item != nullptr )
-            return child_item;
-        }
-      }
-    }
-  }
-  return nullptr;
+  Items::Item* item = system_find_item( objserial );
+  if ( item == nullptr || !holds( item, true ) )
+    return nullptr;
+  return item;
 }
 
 Items::Item* UContainer::find_toplevel( u32 objserial ) const
 {
-  for ( auto& item : contents_ )
-  {
-    passert( item != nullptr );
-    if ( item != nullptr )
-    {
-      if ( item->serial == objserial )
-        return item;
-    }
-  }
-  return nullptr;
+  Items::Item* item = system_find_item( objserial );
+  if ( item == nullptr || item->container != this )
+    return nullptr;
+  return item;
 }
 
 void UContainer::for_each_item( void ( *f )( Items::Item* item, void* a ), void* arg )
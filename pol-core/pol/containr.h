@@ -236,6 +236,8 @@ protected:
   Items::Item* find(
       u32 serial,
       iterator& where_in_container );  // return the position in the array where it was found.
+  bool holds( const Items::Item* item, bool check_locks ) const;
+  void collect_objtype_noninuse( u32 objtype, std::vector<Items::Item*>& items ) const;
 
   // sticky places that currently need to know the internals:
   friend class UContainerIterator;
@@ -10,11 +10,14 @@
 
 #include "decay.h"
 
+#include <algorithm>
 #include <stddef.h>
+#include <vector>
 
 #include "../clib/esignal.h"
 #include "../clib/logfacility.h"
 #include "../plib/systemstate.h"
+#include "fnsearch.h"
 #include "gameclck.h"
 #include "globals/state.h"
 #include "globals/uvars.h"
@@ -50,6 +53,41 @@ namespace Pol::Core
 ///     before destroying the container.
 ///
 
+namespace
+{
+void count_active_items( Realms::Realm* realm, const Zone& zone )
+{
+  for ( const auto& item : zone.items )
+  {
+    if ( !item->can_decay() )
+      continue;
+    const Items::ItemDesc& descriptor = item->itemdesc();
+    if ( !descriptor.decays_on_multis )
+    {
+      Multi::UMulti* multi = realm->find_supporting_multi( item->pos3d() );
+      if ( multi == nullptr )
+        stateManager.decay_statistics.temp_count_active++;
+    }
+    else
+      stateManager.decay_statistics.temp_count_active++;
+  }
+}
+
+// every change of the decay time pushes a new entry, without cleanup the queue of a zone with
+// long living items would only grow
+void compact_decay_queue( Zone& zone )
+{
+  if ( zone.decay_queue.size() <= 4 * zone.items.size() + 16 )
+    return;
+  zone.decay_queue.clear();
+  for ( const auto& item : zone.items )
+  {
+    if ( item->decayat() != 0 )
+      zone.decay_queue.push( item->decayat(), item->serial );
+  }
+}
+}  // namespace
+
 void Decay::decay_worldzone()
 {
   auto* realm = gamestate.Realms[realm_index];
@@ -57,61 +95,84 @@ void Decay::decay_worldzone()
   gameclock_t now = read_gameclock();
   bool statistics = Plib::systemstate.config.thread_decay_statistics;
 
-  for ( ZoneItems::size_type idx = 0; idx < zone.items.size(); ++idx )
+  if ( statistics && statistics_sweep() )
+    count_active_items( realm, zone );
+  if ( !zone.decay_queue.due( now ) )
+    return;
+
+  // collect first, the queue gets new entries while decaying (eg spilled container contents)
+  std::vector<ZoneDecayQueue::Entry> due;
+  while ( zone.decay_queue.due( now ) )
+    due.push_back( zone.decay_queue.pop() );
+  std::sort( due.begin(), due.end(),
+             []( const ZoneDecayQueue::Entry& a, const ZoneDecayQueue::Entry& b )
+             { return a.serial < b.serial; } );
+  due.erase( std::unique( due.begin(), due.end(),
+                          []( const ZoneDecayQueue::Entry& a, const ZoneDecayQueue::Entry& b )
+                          { return a.serial == b.serial; } ),
+             due.end() );
+
+  for ( const auto& entry : due )
   {
-    Items::Item* item = zone.items[idx];
-    if ( statistics )
+    Items::Item* item = system_find_item( entry.serial );
+    // outdated entry: destroyed, moved away or the decay time changed which pushed a newer entry
+    if ( item == nullptr || item->container != nullptr || item->realm() != realm ||
+         &realm->getzone( item->pos2d() ) != &zone )
+      continue;
+    if ( item->decayat() == 0 || item->decayat() >= now )
+      continue;
+    if ( !item->can_decay() )
     {
-      if ( item->can_decay() )
-      {
-        const Items::ItemDesc& descriptor = item->itemdesc();
-        if ( !descriptor.decays_on_multis )
-        {
-          Multi::UMulti* multi = realm->find_supporting_multi( item->pos3d() );
-          if ( multi == nullptr )
-            stateManager.decay_statistics.temp_count_active++;
-        }
-        else
-          stateManager.decay_statistics.temp_count_active++;
-      }
+      zone.decay_queue.push( now + DECAY_RECHECK_DELAY, item->serial );
+      continue;
     }
-    if ( item->should_decay( now ) )
+
+    // check the CanDecay syshook first if it returns 1 go over to other checks
+    bool skipchecks = false;
+    if ( gamestate.system_hooks.can_decay )
     {
-      // check the CanDecay syshook first if it returns 1 go over to other checks
-      bool skipchecks = false;
-      if ( gamestate.system_hooks.can_decay )
+      auto res = gamestate.system_hooks.can_decay->call_long( new Module::EItemRefObjImp( item ) );
+      if ( !res )
       {
-        auto res =
-            gamestate.system_hooks.can_decay->call_long( new Module::EItemRefObjImp( item ) );
-        if ( !res )
-          continue;
-        if ( res == SKIP_FURTHER_CHECKS )
-          skipchecks = true;
+        zone.decay_queue.push( now + DECAY_RECHECK_DELAY, item->serial );
+        continue;
       }
+      if ( res == SKIP_FURTHER_CHECKS )
+        skipchecks = true;
+    }
 
-      const Items::ItemDesc& descriptor = item->itemdesc();
-      Multi::UMulti* multi = realm->find_supporting_multi( item->pos3d() );
-      if ( !skipchecks )
+    const Items::ItemDesc& descriptor = item->itemdesc();
+    Multi::UMulti* multi = realm->find_supporting_multi( item->pos3d() );
+    if ( !skipchecks )
+    {
+      // some things don't decay on multis:
+      if ( multi != nullptr && !descriptor.decays_on_multis )
       {
-        // some things don't decay on multis:
-        if ( multi != nullptr && !descriptor.decays_on_multis )
-          continue;
+        zone.decay_queue.push( now + DECAY_RECHECK_DELAY, item->serial );
+        continue;
       }
-      if ( statistics )
-        stateManager.decay_statistics.temp_count_decayed++;
+    }
+    if ( statistics )
+      stateManager.decay_statistics.temp_count_decayed++;
 
-      if ( !descriptor.destroy_script.empty() && !item->inuse() )
+    if ( !descriptor.destroy_script.empty() && !item->inuse() )
+    {
+      bool decayok = call_script( descriptor.destroy_script, item->make_ref() );
+      if ( !decayok )
       {
-        bool decayok = call_script( descriptor.destroy_script, item->make_ref() );
-        if ( !decayok )
-          continue;
+        // the script may have destroyed or moved the item itself
+        if ( !item->orphan() && item->container == nullptr )
+          zone.decay_queue.push( now + DECAY_RECHECK_DELAY, item->serial );
+        continue;
       }
-
-      item->spill_contents( multi );
-      destroy_item( item );
-      --idx;
+      if ( item->orphan() )
+        continue;
     }
+
+    item->spill_contents( multi );
+    destroy_item( item );
   }
+  compact_decay_queue( zone );
 }
 
 // check if realm_index is still valid and if y is still in valid range
@@ -132,7 +193,7 @@ void Decay::switch_realm()
   if ( realm_index >= gamestate.Realms.size() )
   {
     realm_index = 0;
-    if ( Plib::systemstate.config.thread_decay_statistics )
+    if ( Plib::systemstate.config.thread_decay_statistics && statistics_sweep() )
     {
       auto& stat = stateManager.decay_statistics;
       stat.decayed.update( stat.temp_count_decayed );
@@ -146,6 +207,7 @@ void Decay::switch_realm()
           stat.active_decay.max(), stat.active_decay.mean(), stat.active_decay.variance(),
           stat.active_decay.count() );
     }
+    ++sweep_count;
   }
   area = gamestate.Realms[realm_index]->gridarea();
   area_itr = area.begin();
@@ -194,9 +256,21 @@ void Decay::calculate_sleeptime()
     POLLOG_ERRORLN( "No realm grids?!" );
     return;
   }
-  // sweep every realm ~10minutes -> 36ms for 6 realms
-  // limit to 30ms-500ms
-  sleeptime = std::clamp( ( 60u * 10u * 1000u ) / total_grid_count, 30u, 500u );
+  // zones without due items cost only a look at their decay queue, so sweep every realm within
+  // ~30s using a fixed tick and as many zones per tick as needed
+  const unsigned tick_ms = 100;
+  const unsigned zones = std::max( 1u, ( total_grid_count * tick_ms + 29999u ) / 30000u );
+  sleeptime = tick_ms;
+  zones_per_tick = zones;
+  // counting the active items scans every item of a zone, keep the old cadence of ~10 minutes
+  const unsigned sweep_ms = ( ( total_grid_count + zones - 1 ) / zones ) * tick_ms;
+  statistics_sweeps = std::max( 1u, ( 60u * 10u * 1000u ) / sweep_ms );
+}
+
+// true while the current sweep counts the active items for the statistics
+bool Decay::statistics_sweep() const
+{
+  return sweep_count % statistics_sweeps == 0;
 }
 void Decay::decay_thread( void* /*arg*/ )
 {
@@ -214,7 +288,8 @@ void Decay::threadloop()
     {
       PolLock lck;
       polclock_checkin();
-      step();
+      for ( unsigned i = 0; i < zones_per_tick; ++i )
+        step();
       restart_all_clients();
     }
     pol_sleep_ms( sleeptime );
@@ -11,6 +11,7 @@
 namespace Pol::Testing
 {
 void decay_test();
+void decay_queue_test();
 }
 namespace Pol::Realms
 {
@@ -28,6 +29,9 @@ public:
   void on_delete_realm( Realms::Realm* realm );
 
   static constexpr int SKIP_FURTHER_CHECKS = 2;
+  // items which are due but refused to decay (in use, on a multi, hook or destroyscript) get
+  // checked again after this delay (gameclock seconds)
+  static constexpr unsigned DECAY_RECHECK_DELAY = 10 * 60;
 
 private:
   void threadloop();
@@ -36,12 +40,18 @@ private:
   void switch_realm();
   void decay_worldzone();
   void calculate_sleeptime();
+  bool statistics_sweep() const;
 
   std::atomic<unsigned> sleeptime = 0;
+  std::atomic<unsigned> zones_per_tick = 1;
+  // the active items of ThreadDecayStatistics are only counted every nth sweep
+  unsigned statistics_sweeps = 1;
+  unsigned sweep_count = 0;
   size_t realm_index = ~0lu;
   Range2d area;
   Range2dItr area_itr;
 
   friend void Pol::Testing::decay_test();
+  friend void Pol::Testing::decay_queue_test();
 };
 }  // namespace Pol::Core
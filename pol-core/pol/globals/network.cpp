@@ -42,6 +42,8 @@ NetworkManager::NetworkManager()
       uoclient_listeners(),
       iostats(),
       queuedmode_iostats(),
+      tooltip_cache(),
+      gump_cache(),
       login_filter( nullptr ),
       game_filter( nullptr ),
       disconnected_filter( nullptr ),
@@ -131,6 +133,8 @@ void NetworkManager::deinialize()
   Network::clean_packethooks();
   curl_global_cleanup();
   uoclient_general.deinitialize();
+  tooltip_cache.clear();
+  gump_cache.clear();
 }
 
 size_t NetworkManager::getNumberOfLoginClients() const
@@ -190,6 +194,8 @@ NetworkManager::Memory NetworkManager::estimateSize() const
       usage.misc += hook->estimateSize();
   }
 
+  usage.misc += tooltip_cache.estimateSize();
+  usage.misc += gump_cache.estimateSize();
   usage.misc += packetsSingleton->estimateSize();
   usage.misc += sizeof( Network::ClientTransmit );
   usage.misc += sizeof( threadhelp::DynTaskThreadPool );
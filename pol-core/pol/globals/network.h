@@ -8,10 +8,12 @@
 #include <vector>
 
 #include "../network/bannedips.h"
+#include "../network/gumpcache.h"
 #include "../network/iostats.h"
 #include "../network/msghandl.h"
 #include "../network/sockio.h"
 #include "../polstats.h"
+#include "../tooltips.h"
 #include "../uoclient.h"
 
 namespace Pol
@@ -77,6 +79,8 @@ public:
 
   Network::IOStats iostats;
   Network::IOStats queuedmode_iostats;
+  TooltipCache tooltip_cache;
+  Network::GumpCache gump_cache;
   std::unique_ptr<MessageTypeFilter> login_filter;
   std::unique_ptr<MessageTypeFilter> game_filter;
   std::unique_ptr<MessageTypeFilter> disconnected_filter;
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -40,6 +41,8 @@ public:
   unsigned int clean_objects;
   unsigned int dirty_objects;
   bool incremental_saves_disabled;
+  // guards incremental_save_count and the incr- files against a finishing forked worldsave
+  std::mutex incremental_save_mutex;
 
   ObjectHash objecthash;
 
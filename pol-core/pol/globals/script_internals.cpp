@@ -266,6 +266,7 @@ void ScriptScheduler::run_ready()
             ex->pChild->pParent = nullptr;
           if ( !ex->keep_alive() )
           {
+            Tools::LatencyTimer teardown_timer( stateManager.tick_histograms.script_teardown );
             delete ex;
           }
           else
@@ -20,7 +20,8 @@ StateManager::StateManager()
       charserialnumber( CHARACTERSERIAL_START ),
       polsig(),
       decay_statistics(),
-      checkin_clock_times_out_at( 0 )
+      checkin_clock_times_out_at( 0 ),
+      tick_histograms()
 {
 }
 
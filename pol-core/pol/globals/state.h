@@ -5,6 +5,7 @@
 
 #include "../../clib/clib.h"
 #include "../../clib/rawtypes.h"
+#include "../../clib/timer.h"
 #include "../polsig.h"
 #include "../profile.h"
 #include "../uobjcnt.h"
@@ -57,6 +58,21 @@ public:
   } decay_statistics;
 
   std::atomic<s64> checkin_clock_times_out_at;
+
+  // latency distributions, served by the webserver under /metrics
+  struct
+  {
+    Tools::LatencyHistogram scripts_pass;
+    Tools::LatencyHistogram tasks_pass;
+    Tools::LatencyHistogram script_start;
+    Tools::LatencyHistogram script_teardown;
+    Tools::LatencyHistogram pollock_wait;
+    Tools::LatencyHistogram pollock_hold;
+    Tools::LatencyHistogram packet_handling;
+    Tools::LatencyHistogram worldsave_blocking;
+    Tools::LatencyHistogram worldsave_total;
+    Tools::LatencyHistogram worldsave_incremental;
+  } tick_histograms;
 };
 
 extern StateManager stateManager;
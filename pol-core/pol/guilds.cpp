@@ -10,8 +10,10 @@
 #include "../clib/fileutil.h"
 #include "../clib/stlutil.h"
 #include "../clib/streamsaver.h"
+#include "../clib/strutil.h"
 #include "../plib/systemstate.h"
 #include "fnsearch.h"
+#include "globals/object_storage.h"
 #include "globals/uvars.h"
 #include "mobile/charactr.h"
 #include "ufunc.h"
@@ -199,6 +201,19 @@ void read_guilds_dat()
 {
   std::string guildsfile = Plib::systemstate.config.world_data_path + "guilds.txt";
 
+  // each incremental save holds the complete guild table, the newest one wins
+  // incremental_save_count is already known here, read_data() loads the incremental indexes first
+  for ( unsigned i = objStorageManager.incremental_save_count; i > 0; --i )
+  {
+    std::string incrfile =
+        Plib::systemstate.config.world_data_path + "incr-guilds-" + Clib::tostring( i ) + ".txt";
+    if ( Clib::FileExists( incrfile ) )
+    {
+      guildsfile = incrfile;
+      break;
+    }
+  }
+
   if ( !Clib::FileExists( guildsfile ) )
     return;
 
@@ -33,6 +33,7 @@
 #include "../objtype.h"
 #include "../polcfg.h"
 #include "../proplist.h"
+#include "../realms/realm.h"
 #include "../scrdef.h"
 #include "../scrsched.h"
 #include "../scrstore.h"
@@ -1105,6 +1106,7 @@ void Item::set_decay_after( unsigned int seconds )
   if ( decayat_gameclock_ != 0 )
   {
     decayat_gameclock_ = Core::read_gameclock() + seconds;
+    schedule_decay();
   }
 }
 
@@ -1113,6 +1115,20 @@ bool Item::can_decay() const
   return !inuse() && ( movable() || ( objtype_ == UOBJ_CORPSE ) ) && decayat_gameclock_;
 }
 
+unsigned int Item::decayat() const
+{
+  return decayat_gameclock_;
+}
+
+// registers the current decay time in the decay queue of the zone, entries which got outdated by
+// moving or changing the decay time are filtered by the decay thread
+void Item::schedule_decay() const
+{
+  if ( decayat_gameclock_ == 0 || container != nullptr || realm() == nullptr )
+    return;
+  realm()->getzone( pos2d() ).decay_queue.push( decayat_gameclock_, serial );
+}
+
 bool Item::should_decay( unsigned int gameclock ) const
 {
   return can_decay() && ( gameclock > decayat_gameclock_ );
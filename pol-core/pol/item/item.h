@@ -121,6 +121,8 @@ public:
   void restart_decay_timer();
   void disable_decay();
   bool can_decay() const;
+  unsigned int decayat() const;
+  void schedule_decay() const;
 
   bool setlayer( unsigned char layer );
   virtual bool setgraphic( u16 newobjtype ) override;
@@ -27,6 +27,7 @@
 #include <ctype.h>
 #include <iterator>
 #include <string>
+#include <vector>
 
 #include "../bscript/eprog.h"
 #include "../bscript/impstr.h"
@@ -601,18 +602,16 @@ void handle_allnames( Client* client, PKTBI_98_IN* msg )
 
 void handle_se_object_list( Client* client, PKTBI_D6_IN* msgin )
 {
-  UObject* obj = nullptr;
   int length = cfBEu16( msgin->msglen ) - 3;
   if ( length < 0 || ( length % 4 ) != 0 )
     return;
   int count = length / 4;
 
+  std::vector<u32> serials;
+  serials.reserve( count );
   for ( int i = 0; i < count; ++i )
-  {
-    obj = system_find_object( cfBEu32( msgin->serials[i].serial ) );
-    if ( obj != nullptr )
-      SendAOSTooltip( client, obj );
-  }
+    serials.push_back( cfBEu32( msgin->serials[i].serial ) );
+  SendAOSTooltips( client, serials );
 }
 
 void handle_ef_seed( Client* client, PKTIN_EF* msg )
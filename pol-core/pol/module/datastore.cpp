@@ -12,6 +12,7 @@
 #include <exception>
 #include <fstream>
 #include <stddef.h>
+#include <vector>
 
 #include "../../bscript/berror.h"
 #include "../../bscript/bobject.h"
@@ -22,6 +23,7 @@
 #include "../../clib/cfgelem.h"
 #include "../../clib/cfgfile.h"
 #include "../../clib/fileutil.h"
+#include "../../clib/logfacility.h"
 #include "../../clib/rawtypes.h"
 #include "../../clib/stlutil.h"
 #include "../../clib/streamsaver.h"
@@ -44,11 +46,28 @@ namespace Module
 ///     config.world_data_path + ds/fname.txt
 ///     config.world_data_path + ds/{pkgname}/fname.txt
 ///
+///  fname is followed by the generation: fname.{version%10}.txt
+///  Changes of large files are appended as deltas to fname.{version%10}.delta.txt,
+///  datastore.txt records how many of them belong to the version.
+///
 
 Bscript::BApplicObjType datafileref_type;
 Bscript::BApplicObjType datafileelem_type;
 
-DataFileContents::DataFileContents( DataStoreFile* dsf ) : dsf( dsf ), dirty( false ) {}
+namespace
+{
+// smaller files are always written completely
+const size_t delta_min_elements = 1000;
+}  // namespace
+
+DataFileContents::DataFileContents( DataStoreFile* dsf )
+    : dsf( dsf ),
+      dirty( false ),
+      full_save_needed( false ),
+      changed_elements( 0 ),
+      delta_elements( 0 )
+{
+}
 
 DataFileContents::~DataFileContents()
 {
@@ -58,8 +77,9 @@ DataFileContents::~DataFileContents()
 
 size_t DataFileContents::estimateSize() const
 {
-  size_t size = sizeof( DataStoreFile* ) /*dsf*/
-                + sizeof( bool );        /*dirty*/
+  size_t size = sizeof( DataStoreFile* )  /*dsf*/
+                + 2 * sizeof( bool )      /*dirty full_save_needed*/
+                + 2 * sizeof( size_t );   /*changed_elements delta_elements*/
 
   size += Clib::memsize( elements_by_string );
   for ( const auto& ele : elements_by_string )
@@ -68,9 +88,15 @@ size_t DataFileContents::estimateSize() const
       size += ele.second->proplist.estimatedSize();
   }
   size += Clib::memsize( elements_by_integer );
+  size += Clib::memsize( deleted_string_keys ) + Clib::memsize( deleted_integer_keys );
   return size;
 }
 
+size_t DataFileContents::element_count() const
+{
+  return elements_by_string.size() + elements_by_integer.size();
+}
+
 void DataFileContents::load( Clib::ConfigFile& cf )
 {
   Clib::ConfigElem elem;
@@ -90,6 +116,67 @@ void DataFileContents::load( Clib::ConfigFile& cf )
   }
 }
 
+// applies the first deltas saves of the file, anything after them was written by a save
+// that never got committed
+void DataFileContents::load_delta( Clib::ConfigFile& cf, unsigned deltas )
+{
+  struct Change
+  {
+    std::string key;
+    DataFileElementRef dfelem;  // none if deleted
+  };
+  std::vector<Change> pending;
+  unsigned applied = 0;
+  Clib::ConfigElem elem;
+
+  while ( applied < deltas && cf.read( elem ) )
+  {
+    if ( elem.type_is( "Commit" ) )
+    {
+      for ( const auto& change : pending )
+      {
+        if ( dsf->flags & DF_KEYTYPE_INTEGER )
+        {
+          int key = atol( change.key.c_str() );
+          if ( change.dfelem.get() != nullptr )
+            elements_by_integer[key] = change.dfelem;
+          else
+            elements_by_integer.erase( key );
+        }
+        else
+        {
+          if ( change.dfelem.get() != nullptr )
+            elements_by_string[change.key] = change.dfelem;
+          else
+            elements_by_string.erase( change.key );
+        }
+      }
+      delta_elements += pending.size();
+      pending.clear();
+      ++applied;
+    }
+    else if ( elem.type_is( "Element" ) )
+    {
+      pending.push_back( Change{ elem.rest(), DataFileElementRef( new DataFileElement( elem ) ) } );
+    }
+    else
+    {
+      pending.push_back( Change{ elem.rest(), DataFileElementRef() } );
+    }
+  }
+
+  if ( applied < deltas )
+  {
+    POLLOG_ERRORLN( "{} contains only {} of {} saved changes.", cf.filename(), applied, deltas );
+    dirty = full_save_needed = true;
+  }
+  else if ( cf.read( elem ) )
+  {
+    // nothing may follow the last commit once new changes get appended
+    dirty = full_save_needed = true;
+  }
+}
+
 void DataFileContents::save( Clib::StreamWriter& sw )
 {
   for ( const auto& element : elements_by_string )
@@ -107,6 +194,61 @@ void DataFileContents::save( Clib::StreamWriter& sw )
   }
 }
 
+void DataFileContents::save_delta( Clib::StreamWriter& sw, unsigned delta )
+{
+  for ( const auto& key : deleted_string_keys )
+  {
+    sw.begin( "Deleted", key );
+    sw.end();
+  }
+  for ( const auto& key : deleted_integer_keys )
+  {
+    sw.begin( "Deleted", key );
+    sw.end();
+  }
+
+  for ( const auto& element : elements_by_string )
+  {
+    if ( !element.second->dirty )
+      continue;
+    sw.begin( "Element", element.first );
+    element.second->printOn( sw );
+    sw.end();
+  }
+  for ( const auto& element : elements_by_integer )
+  {
+    if ( !element.second->dirty )
+      continue;
+    sw.begin( "Element", element.first );
+    element.second->printOn( sw );
+    sw.end();
+  }
+
+  sw.begin( "Commit", delta );
+  sw.end();
+}
+
+void DataFileContents::clear_changes()
+{
+  for ( const auto& element : elements_by_string )
+    element.second->dirty = false;
+  for ( const auto& element : elements_by_integer )
+    element.second->dirty = false;
+  deleted_string_keys.clear();
+  deleted_integer_keys.clear();
+  changed_elements = 0;
+}
+
+void DataFileContents::element_changed( DataFileElement* dfelem )
+{
+  if ( !dfelem->dirty )
+  {
+    dfelem->dirty = true;
+    ++changed_elements;
+  }
+  dirty = true;
+}
+
 Bscript::BObjectImp* DataFileContents::methodCreateElement( int key )
 {
   ElementsByInteger::iterator itr = elements_by_integer.find( key );
@@ -115,6 +257,7 @@ Bscript::BObjectImp* DataFileContents::methodCreateElement( int key )
   {
     dfelem.set( new DataFileElement );
     elements_by_integer[key] = dfelem;
+    ++changed_elements;
     dirty = true;
   }
   else
@@ -132,6 +275,7 @@ Bscript::BObjectImp* DataFileContents::methodCreateElement( const std::string& k
   {
     dfelem.set( new DataFileElement );
     elements_by_string[key] = dfelem;
+    ++changed_elements;
     dirty = true;
   }
   else
@@ -175,6 +319,8 @@ Bscript::BObjectImp* DataFileContents::methodDeleteElement( int key )
 {
   if ( elements_by_integer.erase( key ) )
   {
+    deleted_integer_keys.insert( key );
+    ++changed_elements;
     dirty = true;
     return new Bscript::BLong( 1 );
   }
@@ -186,6 +332,8 @@ Bscript::BObjectImp* DataFileContents::methodDeleteElement( const std::string& k
 {
   if ( elements_by_string.erase( key ) )
   {
+    deleted_string_keys.insert( key );
+    ++changed_elements;
     dirty = true;
     return new Bscript::BLong( 1 );
   }
@@ -349,7 +497,7 @@ Bscript::BObjectImp* DataElemRefObjImp::call_method_id( const int id, Bscript::E
   bool changed = false;
   Bscript::BObjectImp* res = CallPropertyListMethod_id( obj_.dfelem->proplist, id, ex, changed );
   if ( changed )
-    obj_.dfcontents->dirty = true;
+    obj_.dfcontents->element_changed( obj_.dfelem.get() );
   return res;
 }
 
@@ -359,7 +507,7 @@ Bscript::BObjectImp* DataElemRefObjImp::call_method( const char* methodname, Bsc
   Bscript::BObjectImp* res =
       CallPropertyListMethod( obj_.dfelem->proplist, methodname, ex, changed );
   if ( changed )
-    obj_.dfcontents->dirty = true;
+    obj_.dfcontents->element_changed( obj_.dfelem.get() );
   return res;
 }
 
@@ -569,7 +717,8 @@ DataStoreFile::DataStoreFile( Clib::ConfigElem& elem )
       oldversion( elem.remove_ushort( "OldVersion" ) ),
       flags( elem.remove_ulong( "Flags" ) ),
       unload( false ),
-      delversion( 0 )
+      delversion( 0 ),
+      deltas( elem.remove_ulong( "Deltas", 0 ) )
 {
 }
 
@@ -583,7 +732,8 @@ DataStoreFile::DataStoreFile( const std::string& descriptor, const Plib::Package
       oldversion( 0 ),
       flags( flags ),
       unload( false ),
-      delversion( 0 )
+      delversion( 0 ),
+      deltas( 0 )
 {
   if ( pkg != nullptr )
     pkgname = pkg->name();
@@ -606,11 +756,27 @@ void DataStoreFile::load()
   {
     Clib::ConfigFile cf( filename().c_str(), "Element" );
     dfcontents->load( cf );
+
+    if ( deltas )
+    {
+      std::string deltafn = delta_filename( version );
+      if ( Clib::FileExists( deltafn ) )
+      {
+        Clib::ConfigFile cf_delta( deltafn, "Element Deleted Commit" );
+        dfcontents->load_delta( cf_delta, deltas );
+      }
+      else
+      {
+        POLLOG_ERRORLN( "{} is missing, {} saved changes are lost.", deltafn, deltas );
+        dfcontents->dirty = dfcontents->full_save_needed = true;
+      }
+    }
   }
   else
   {
     // just force an empty file to be written
     dfcontents->dirty = true;
+    dfcontents->full_save_needed = true;
   }
 }
 
@@ -631,6 +797,8 @@ void DataStoreFile::printOn( Clib::StreamWriter& sw ) const
   sw.add( "Flags", flags );
   sw.add( "Version", version );
   sw.add( "OldVersion", oldversion );
+  if ( deltas )
+    sw.add( "Deltas", deltas );
   sw.end();
 }
 
@@ -648,6 +816,15 @@ std::string DataStoreFile::filename() const
   return filename( version );
 }
 
+std::string DataStoreFile::delta_filename( unsigned ver ) const
+{
+  std::string tmp = Plib::systemstate.config.world_data_path + "ds/";
+  if ( pkg != nullptr )
+    tmp += pkg->name() + "/";
+  tmp += name + "." + Clib::tostring( ver % 10 ) + ".delta.txt";
+  return tmp;
+}
+
 void DataStoreFile::save() const
 {
   std::string fname = filename();
@@ -656,11 +833,39 @@ void DataStoreFile::save() const
   dfcontents->save( sw );
 }
 
+void DataStoreFile::save_delta() const
+{
+  std::string fname = delta_filename( version );
+  // the first delta of a version replaces whatever an older generation left behind
+  std::ofstream ofs( fname.c_str(), deltas ? std::ios::out | std::ios::app : std::ios::out );
+  {
+    Clib::StreamWriter sw( &ofs );
+    dfcontents->save_delta( sw, deltas + 1 );
+  }
+  ofs.close();
+  if ( ofs.fail() )
+  {
+    // a partly appended delta can't be followed by further ones
+    dfcontents->full_save_needed = true;
+    throw std::runtime_error( "Unable to write " + fname );
+  }
+}
+
+// changes of large files are appended as a delta until the deltas hold as many elements as
+// half of the file, then a new generation is written
+bool DataStoreFile::use_delta() const
+{
+  const DataFileContents* contents = dfcontents.get();
+  size_t count = contents->element_count();
+  return !contents->full_save_needed && count >= delta_min_elements &&
+         contents->delta_elements + contents->changed_elements <= count / 2;
+}
+
 size_t DataStoreFile::estimateSize() const
 {
   size_t size = descriptor.capacity() + name.capacity() + pkgname.capacity() +
                 sizeof( Plib::Package* ) /*pkg*/
-                + 3 * sizeof( unsigned ) /*version oldversion delversion*/
+                + 4 * sizeof( unsigned ) /*version oldversion delversion deltas*/
                 + sizeof( int )          /*flags*/
                 + sizeof( bool )         /*unload*/
                 + sizeof( DataFileContentsRef );
@@ -670,10 +875,13 @@ size_t DataStoreFile::estimateSize() const
 }
 
 
-DataFileElement::DataFileElement() : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ) {}
+DataFileElement::DataFileElement()
+    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ), dirty( true )
+{
+}
 
 DataFileElement::DataFileElement( Clib::ConfigElem& elem )
-    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT )
+    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ), dirty( false )
 {
   proplist.readRemainingPropertiesAsStrings( elem );
 }
@@ -700,6 +908,41 @@ void read_datastore_dat()
   }
 }
 
+namespace
+{
+// advances the generation of a file and stores its changes, write is false in the server
+// process of a forked save, its child writes the files
+void save_datastore_file( DataStoreFile* dsf, bool write )
+{
+  dsf->delversion = dsf->oldversion;
+  dsf->oldversion = dsf->version;
+
+  DataFileContents* contents = dsf->dfcontents.get();
+  if ( contents == nullptr || !contents->dirty )
+    return;
+
+  if ( dsf->use_delta() )
+  {
+    if ( write )
+      dsf->save_delta();
+    ++dsf->deltas;
+    contents->delta_elements += contents->changed_elements;
+  }
+  else
+  {
+    // make a new generation of file and write it.
+    ++dsf->version;
+    dsf->deltas = 0;
+    if ( write )
+      dsf->save();
+    contents->delta_elements = 0;
+    contents->full_save_needed = false;
+  }
+  contents->clear_changes();
+  contents->dirty = false;
+}
+}  // namespace
+
 void write_datastore( Clib::StreamWriter& sw )
 {
   for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
@@ -707,24 +950,29 @@ void write_datastore( Clib::StreamWriter& sw )
   {
     DataStoreFile* dsf = ( *itr ).second;
 
-    dsf->delversion = dsf->oldversion;
-    dsf->oldversion = dsf->version;
-
-    if ( dsf->dfcontents.get() && dsf->dfcontents->dirty )
-    {
-      // make a new generation of file and write it.
-      ++dsf->version;
-
-      dsf->save();
-
-      dsf->dfcontents->dirty = false;
-    }
+    save_datastore_file( dsf, true );
 
     dsf->printOn( sw );
     // sw.flush();
   }
 }
 
+void unload_if_requested( DataStoreFile* dsf )
+{
+  if ( dsf->unload )
+  {
+    if ( dsf->dfcontents.get() != nullptr )
+    {
+      // changes made after a forked save started keep the file loaded
+      if ( dsf->dfcontents->count() == 1 && !dsf->dfcontents->dirty )
+      {
+        dsf->dfcontents.clear();
+      }
+    }
+    dsf->unload = false;
+  }
+}
+
 void commit_datastore()
 {
   for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
@@ -735,18 +983,44 @@ void commit_datastore()
     if ( dsf->delversion != dsf->version && dsf->delversion != dsf->oldversion )
     {
       Clib::RemoveFile( dsf->filename( dsf->delversion ) );
+      std::string deltafn = dsf->delta_filename( dsf->delversion );
+      if ( Clib::FileExists( deltafn ) )
+        Clib::RemoveFile( deltafn );
     }
 
-    if ( dsf->unload )
+    unload_if_requested( dsf );
+  }
+}
+
+// A forked worldsave writes the datastore files from the memory of the child process.
+// The file generations of the server have to advance the same way.
+void advance_datastore_versions()
+{
+  for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
+        itr != Core::configurationbuffer.datastore.end(); ++itr )
+  {
+    save_datastore_file( ( *itr ).second, false );
+  }
+}
+
+// old generations were already removed by the child, only unloading is left.
+// If the save failed every loaded file gets written again by the next one.
+void finish_forked_datastore_save( bool success )
+{
+  for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
+        itr != Core::configurationbuffer.datastore.end(); ++itr )
+  {
+    DataStoreFile* dsf = ( *itr ).second;
+
+    if ( !success )
     {
+      // the changes are no longer tracked per element, and the delta may be incomplete
       if ( dsf->dfcontents.get() != nullptr )
-      {
-        if ( dsf->dfcontents->count() == 1 )
-        {
-          dsf->dfcontents.clear();
-        }
-      }
-      dsf->unload = false;
+        dsf->dfcontents->dirty = dsf->dfcontents->full_save_needed = true;
+    }
+    else
+    {
+      unload_if_requested( dsf );
     }
   }
 }
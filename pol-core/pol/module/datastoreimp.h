@@ -12,6 +12,7 @@
 #include "../proplist.h"
 
 #include <map>
+#include <set>
 #include <string>
 
 namespace Pol
@@ -36,6 +37,8 @@ public:
   void printOn( Clib::StreamWriter& sw ) const;
 
   Core::PropertyList proplist;
+  // changed since the last save
+  bool dirty;
 };
 typedef ref_ptr<DataFileElement> DataFileElementRef;
 
@@ -50,7 +53,12 @@ public:
   size_t estimateSize() const;
 
   void load( Clib::ConfigFile& cf );
+  void load_delta( Clib::ConfigFile& cf, unsigned deltas );
   void save( Clib::StreamWriter& sw );
+  void save_delta( Clib::StreamWriter& sw, unsigned delta );
+  void clear_changes();
+  void element_changed( DataFileElement* dfelem );
+  size_t element_count() const;
 
   Bscript::BObjectImp* methodCreateElement( int key );
   Bscript::BObjectImp* methodCreateElement( const std::string& key );
@@ -65,6 +73,11 @@ public:
 
   DataStoreFile* dsf;
   bool dirty;
+  // the file on disk can't be extended by a delta, the next save writes everything
+  bool full_save_needed;
+  // elements changed since the last save, elements in the deltas since the last full save
+  size_t changed_elements;
+  size_t delta_elements;
 
 private:
   typedef std::map<std::string, DataFileElementRef, Clib::ci_cmp_pred> ElementsByString;
@@ -72,6 +85,8 @@ private:
 
   ElementsByString elements_by_string;
   ElementsByInteger elements_by_integer;
+  std::set<std::string, Clib::ci_cmp_pred> deleted_string_keys;
+  std::set<int> deleted_integer_keys;
 };
 typedef ref_ptr<DataFileContents> DataFileContentsRef;
 
@@ -133,8 +148,11 @@ public:
   bool loaded() const;
   void load();
   void save() const;
+  void save_delta() const;
+  bool use_delta() const;
   std::string filename() const;
   std::string filename( unsigned ver ) const;
+  std::string delta_filename( unsigned ver ) const;
   void printOn( Clib::StreamWriter& sw ) const;
 
   std::string descriptor;
@@ -148,6 +166,8 @@ public:
   bool unload;
 
   unsigned delversion;
+  // saved changes appended to the delta file of version
+  unsigned deltas;
 
   DataFileContentsRef dfcontents;
 };
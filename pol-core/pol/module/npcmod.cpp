@@ -811,10 +811,10 @@ BObjectImp* NPCExecutorModule::mf_GetProperty()
   const String* propname_str;
   if ( exec.getStringParam( 0, propname_str ) )
   {
-    std::string val;
-    if ( npc.getprop( propname_str->value(), val ) )
+    BObjectImp* val = npc.getpropimp( propname_str->value() );
+    if ( val != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return val;
     }
     else
     {
@@ -833,7 +833,7 @@ BObjectImp* NPCExecutorModule::mf_SetProperty()
   if ( exec.getStringParam( 0, propname_str ) )
   {
     BObjectImp* propval = getParamImp( 1 );
-    npc.setprop( propname_str->value(), propval->pack() );
+    npc.setpropimp( propname_str->value(), *propval );
     return new BLong( 1 );
   }
   else
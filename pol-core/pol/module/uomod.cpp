@@ -1772,10 +1772,10 @@ BObjectImp* UOExecutorModule::mf_GetObjProperty()
   const String* propname_str;
   if ( getUObjectParam( 0, uobj ) && getStringParam( 1, propname_str ) )
   {
-    std::string val;
-    if ( uobj->getprop( propname_str->value(), val ) )
+    BObjectImp* val = uobj->getpropimp( propname_str->value() );
+    if ( val != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return val;
     }
     else
     {
@@ -1795,7 +1795,7 @@ BObjectImp* UOExecutorModule::mf_SetObjProperty()
   if ( getUObjectParam( 0, uobj ) && getStringParam( 1, propname_str ) )
   {
     BObjectImp* propval = getParamImp( 2 );
-    uobj->setprop( propname_str->value(), propval->pack() );
+    uobj->setpropimp( propname_str->value(), *propval );
     return new BLong( 1 );
   }
   else
@@ -1844,10 +1844,10 @@ BObjectImp* UOExecutorModule::mf_GetGlobalProperty()
   const String* propname_str;
   if ( getStringParam( 0, propname_str ) )
   {
-    std::string val;
-    if ( gamestate.global_properties->getprop( propname_str->value(), val ) )
+    BObjectImp* val = gamestate.global_properties->getpropimp( propname_str->value() );
+    if ( val != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return val;
     }
     else
     {
@@ -1866,7 +1866,7 @@ BObjectImp* UOExecutorModule::mf_SetGlobalProperty()
   if ( exec.getStringParam( 0, propname_str ) )
   {
     BObjectImp* propval = exec.getParamImp( 1 );
-    gamestate.global_properties->setprop( propname_str->value(), propval->pack() );
+    gamestate.global_properties->setpropimp( propname_str->value(), *propval );
     return new BLong( 1 );
   }
   else
@@ -43,6 +43,7 @@
 #include "../../bscript/eprog.h"
 #include "../../bscript/executor.h"
 #include "../../bscript/impstr.h"
+#include "../../bscript/scriptprofile.h"
 #include "../../clib/Program/ProgramConfig.h"
 #include "../../clib/clib.h"
 #include "../../clib/clib_endian.h"
@@ -62,6 +63,7 @@
 #include "../core.h"
 #include "../exscrobj.h"
 #include "../globals/memoryusage.h"
+#include "../globals/network.h"
 #include "../globals/object_storage.h"
 #include "../globals/script_internals.h"
 #include "../globals/state.h"
@@ -1161,19 +1163,15 @@ BObjectImp* UOExecutorModule::internal_SendCompressedGumpMenu( Character* chr, O
   layoutdlen++;
   bfr->offset++;  // nullterm
 
-  unsigned long cbuflen =
-      ( ( (unsigned long)( ( (float)( layoutdlen ) ) * 1.001f ) ) + 12 );  // as per zlib spec
-  if ( cbuflen > ( (unsigned long)( 0xFFFF - msg->offset ) ) )
-  {
-    return new BError( "Compression error" );
-  }
-
-  if ( compress2( reinterpret_cast<unsigned char*>( msg->getBuffer() ), &cbuflen,
-                  reinterpret_cast<unsigned char*>( &bfr->buffer ), layoutdlen,
-                  Z_DEFAULT_COMPRESSION ) != Z_OK )
+  // identical layouts of repeatedly sent dialogs are compressed only once
+  const std::vector<u8>* compressed =
+      networkManager.gump_cache.compress( bfr->buffer, layoutdlen );
+  if ( compressed == nullptr || compressed->size() > static_cast<size_t>( 0xFFFF - msg->offset ) )
   {
     return new BError( "Compression error" );
   }
+  u32 cbuflen = static_cast<u32>( compressed->size() );
+  memcpy( msg->getBuffer(), compressed->data(), cbuflen );
   msg->offset -= 8;
   msg->WriteFlipped<u32>( cbuflen + 4 );
   msg->WriteFlipped<u32>( layoutdlen );
@@ -1208,17 +1206,20 @@ BObjectImp* UOExecutorModule::internal_SendCompressedGumpMenu( Character* chr, O
   {
     msg->offset += 8;  // u32 text_clen, text_dlen
 
-    cbuflen = ( ( (unsigned long)( ( (float)( datadlen ) ) * 1.001f ) ) + 12 );  // as per zlib spec
-    if ( cbuflen > ( (unsigned long)( 0xFFFF - msg->offset ) ) )
+    // texts differ per player, they are not cached
+    unsigned long textclen =
+        ( ( (unsigned long)( ( (float)( datadlen ) ) * 1.001f ) ) + 12 );  // as per zlib spec
+    if ( textclen > ( (unsigned long)( 0xFFFF - msg->offset ) ) )
     {
       return new BError( "Compression error" );
     }
-    if ( compress2( reinterpret_cast<unsigned char*>( msg->getBuffer() ), &cbuflen,
+    if ( compress2( reinterpret_cast<unsigned char*>( msg->getBuffer() ), &textclen,
                     reinterpret_cast<unsigned char*>( &bfr->buffer ), datadlen,
                     Z_DEFAULT_COMPRESSION ) != Z_OK )
     {
       return new BError( "Compression error" );
     }
+    cbuflen = static_cast<u32>( textclen );
 
     msg->offset -= 8;
     msg->WriteFlipped<u32>( cbuflen + 4 );
@@ -1785,6 +1786,39 @@ BObjectImp* GetScriptProfiles()
   return arr.release();
 }
 
+BObjectImp* GetHotspotsObj( const std::vector<ScriptProfile::Hotspot>& spots )
+{
+  std::unique_ptr<ObjArray> arr = std::make_unique<ObjArray>();
+  for ( const auto& spot : spots )
+  {
+    std::unique_ptr<BStruct> elem = std::make_unique<BStruct>();
+    elem->addMember( "name", new String( spot.name ) );
+    elem->addMember( "instr", new Double( static_cast<double>( spot.instructions ) ) );
+    elem->addMember( "samples", new Double( static_cast<double>( spot.samples ) ) );
+    elem->addMember( "time_us", new Double( spot.nanoseconds / 1000.0 ) );
+    arr->addElement( elem.release() );
+  }
+  return arr.release();
+}
+
+BObjectImp* GetScriptHotspots()
+{
+  std::unique_ptr<ObjArray> arr = std::make_unique<ObjArray>();
+  for ( const auto& src : scriptScheduler.scrstore )
+  {
+    EScriptProgram* eprog = src.second.get();
+    if ( !eprog->instr_cycles && !ScriptProfile::has_samples( *eprog ) )
+      continue;
+
+    std::unique_ptr<BStruct> elem = std::make_unique<BStruct>();
+    elem->addMember( "name", new String( eprog->name ) );
+    elem->addMember( "functions", GetHotspotsObj( ScriptProfile::functions( *eprog ) ) );
+    elem->addMember( "lines", GetHotspotsObj( ScriptProfile::lines( *eprog, 20 ) ) );
+    arr->addElement( elem.release() );
+  }
+  return arr.release();
+}
+
 BObjectImp* GetIoStatsObj( const IOStats& stats )
 {
   std::unique_ptr<BStruct> arr( new BStruct );
@@ -1811,6 +1845,11 @@ BObjectImp* GetIoStatsObj( const IOStats& stats )
     received->addElement( elem.release() );
   }
 
+  std::unique_ptr<BStruct> sends = std::make_unique<BStruct>();
+  sends->addMember( "calls", new BLong( stats.sends.calls ) );
+  sends->addMember( "bytes", new BLong( stats.sends.bytes ) );
+  arr->addMember( "sends", sends.release() );
+
   return arr.release();
 }
 
@@ -1906,6 +1945,10 @@ BObjectImp* GetCoreVariable( const char* corevar )
     return GetAllScriptList();
   if ( stricmp( corevar, "script_profiles" ) == 0 )
     return GetScriptProfiles();
+  if ( stricmp( corevar, "script_hotspots" ) == 0 )
+    return GetScriptHotspots();
+  if ( stricmp( corevar, "script_sample_interval" ) == 0 )
+    return new BLong( ScriptProfile::sample_interval.load() );
   if ( stricmp( corevar, "iostats" ) == 0 )
     return GetIoStats();
   if ( stricmp( corevar, "queued_iostats" ) == 0 )
@@ -1960,6 +2003,33 @@ BObjectImp* PolCore::call_polmethod( const char* methodname, UOExecutor& ex )
     clear_script_profile_counters();
     return new BLong( 1 );
   }
+  else if ( stricmp( methodname, "set_script_sampling" ) == 0 )
+  {
+    if ( ex.numParams() != 1 )
+      return new BError( "polcore.set_script_sampling(interval) requires 1 parameter." );
+    int interval;
+    if ( ex.getParam( 0, interval, 0, 1000000 ) )
+    {
+      ScriptProfile::sample_interval = static_cast<unsigned>( interval );
+      return new BLong( 1 );
+    }
+    else
+    {
+      return nullptr;
+    }
+  }
+  else if ( stricmp( methodname, "log_script_stacks" ) == 0 )
+  {
+    if ( ex.numParams() != 1 )
+      return new BError( "polcore.log_script_stacks(clear) requires 1 parameter." );
+    int clear;
+    if ( ex.getParam( 0, clear ) )
+    {
+      if ( !log_script_profile_stacks( clear ? true : false ) )
+        return new BError( "Unable to write log/scriptprofile.folded" );
+      return new BLong( 1 );
+    }
+  }
   else if ( stricmp( methodname, "internal" ) == 0 )  // Just for internal Development...
   {
     int type;
@@ -105,7 +105,7 @@ size_t CustomHouseDesign::estimatedSize() const
 {
   size_t size = sizeof( CustomHouseDesign );
   for ( int i = 0; i < CUSTOM_HOUSE_NUM_PLANES; i++ )
-    size += Elements[i].estimatedSize();
+    size += Elements[i].estimatedSize() + compressed_planes[i].data.capacity();
   return size;
 }
 
@@ -120,6 +120,7 @@ void CustomHouseDesign::InitDesign( u32 _height, u32 _width, s32 xoffset, s32 yo
   for ( int i = 0; i < CUSTOM_HOUSE_NUM_PLANES; i++ )
   {
     floor_sizes[i] = 0;
+    PlaneChanged( i );
     Elements[i].SetWidth( _width );
     Elements[i].SetHeight( _height );
     Elements[i].xoff = xoffset;
@@ -133,6 +134,7 @@ CustomHouseDesign& CustomHouseDesign::operator=( const CustomHouseDesign& design
   {
     Elements[i] = design.Elements[i];
     floor_sizes[i] = design.floor_sizes[i];
+    compressed_planes[i] = design.compressed_planes[i];
   }
   return *this;
 }
@@ -145,6 +147,7 @@ void CustomHouseDesign::Add( CUSTOM_HOUSE_ELEMENT& elem )
     return;
   Elements[floor_num].AddElement( elem );
   floor_sizes[floor_num]++;
+  PlaneChanged( floor_num );
 }
 
 // fixme: low walls not being replaced
@@ -200,6 +203,7 @@ bool CustomHouseDesign::Erase( u32 xoffset, u32 yoffset, u8 z, int minheight )
     {
       column->erase( itr );
       floor_sizes[floor_num]--;
+      PlaneChanged( floor_num );
       return true;
     }
   }
@@ -225,6 +229,7 @@ bool CustomHouseDesign::EraseGraphicAt( u16 graphic, u32 xoffset, u32 yoffset, u
     {
       column->erase( itr );
       floor_sizes[floor_num]--;
+      PlaneChanged( floor_num );
       return true;
     }
   }
@@ -284,66 +289,61 @@ void CustomHouseDesign::Clear()
       }
     }
     floor_sizes[i] = 0;
+    PlaneChanged( i );
   }
 }
 
-// caller must delete, assume type 0
-unsigned char* CustomHouseDesign::Compress( int floor, u32* uncompr_length, u32* compr_length )
+// assume type 0
+bool CustomHouseDesign::Compress( int floor, std::vector<u8>& compressed,
+                                  u32* uncompr_length ) const
 {
-  int numtiles = floor_sizes[floor];
-  int nextindex = 0;
-  unsigned int ubuflen = numtiles * BYTES_PER_TILE;
-  unsigned long cbuflen =
-      ( ( (unsigned long)( ( (float)( ubuflen ) ) * 1.001f ) ) + 12 );  // as per zlib spec
-  unsigned char* uncompressed = new unsigned char[ubuflen];
-  memset( uncompressed, 0, ubuflen );
-  unsigned char* compressed = new unsigned char[cbuflen];
-  memset( compressed, 0, cbuflen );
-
-  int i = 0;
-  for ( HouseFloor::const_iterator xitr = Elements[floor].data.begin(),
-                                   xitrend = Elements[floor].data.end();
-        xitr != xitrend; ++xitr )
+  std::vector<u8> uncompressed;
+  uncompressed.reserve( floor_sizes[floor] * BYTES_PER_TILE );
+
+  for ( const auto& row : Elements[floor].data )
   {
-    i = 0;
-    for ( HouseFloorRow::const_iterator yitr = xitr->begin(), yitrend = xitr->end();
-          yitr != yitrend; ++yitr )
+    for ( const auto& column : row )
     {
-      for ( HouseFloorZColumn::const_iterator zitr = yitr->begin(), zitrend = yitr->end();
-            zitr != zitrend; ++zitr, ++i )
+      for ( const auto& elem : column )
       {
         // assume type 0, I don't know how to deal with stair pieces at odd Z values for mode 1,
         // and mode 2 is just wacky. (position implied from list position, needs alot of null tiles
         // to make that work (but they compress very well)
-        if ( i < numtiles )
-        {
-          uncompressed[nextindex++] = (u8)( ( zitr->graphic >> 8 ) & 0xFF );
-          uncompressed[nextindex++] = (u8)( zitr->graphic & 0xFF );
-
-          uncompressed[nextindex++] = (u8)zitr->xoffset;
-          uncompressed[nextindex++] = (u8)zitr->yoffset;
-          uncompressed[nextindex++] = (u8)zitr->z;
-        }
+        uncompressed.push_back( (u8)( ( elem.graphic >> 8 ) & 0xFF ) );
+        uncompressed.push_back( (u8)( elem.graphic & 0xFF ) );
+        uncompressed.push_back( (u8)elem.xoffset );
+        uncompressed.push_back( (u8)elem.yoffset );
+        uncompressed.push_back( (u8)elem.z );
       }
     }
   }
-  *uncompr_length = nextindex;
 
-  int ret = compress2( compressed, &cbuflen, uncompressed, nextindex, Z_DEFAULT_COMPRESSION );
-  if ( ret == Z_OK )
+  unsigned long cbuflen = compressBound( static_cast<unsigned long>( uncompressed.size() ) );
+  compressed.resize( cbuflen );
+  int ret = compress2( compressed.data(), &cbuflen, uncompressed.data(),
+                       static_cast<unsigned long>( uncompressed.size() ), Z_DEFAULT_COMPRESSION );
+  if ( ret != Z_OK )
   {
-    delete[] uncompressed;
-    *compr_length = cbuflen;
-    return compressed;
+    *uncompr_length = 0;
+    compressed.clear();
+    return false;
   }
-  else
+  *uncompr_length = static_cast<u32>( uncompressed.size() );
+  compressed.resize( cbuflen );
+  return true;
+}
+
+const std::vector<u8>* CustomHouseDesign::CompressedPlane( int floor, u32* uncompr_length )
+{
+  PlaneCache& plane = compressed_planes[floor];
+  if ( !plane.valid )
   {
-    *uncompr_length = 0;
-    *compr_length = 0;
-    delete[] compressed;
-    delete[] uncompressed;
-    return nullptr;
+    if ( !Compress( floor, plane.data, &plane.uncompr_length ) )
+      return nullptr;
+    plane.valid = true;
   }
+  *uncompr_length = plane.uncompr_length;
+  return &plane.data;
 }
 
 bool CustomHouseDesign::IsEmpty() const
@@ -607,6 +607,7 @@ void CustomHouseDesign::FillComponents( UHouse* house, bool add_as_component )
             }
             zitr = yitr->erase( zitr );
             floor_sizes[i]--;
+            PlaneChanged( i );
           }
           else if ( zitr->graphic >= TELEPORTER_START &&
                     zitr->graphic <= TELEPORTER_END )  // teleporters
@@ -649,6 +650,7 @@ void CustomHouseDesign::FillComponents( UHouse* house, bool add_as_component )
             }
             zitr = yitr->erase( zitr );
             floor_sizes[i]--;
+            PlaneChanged( i );
           }
           else
             ++zitr;
@@ -1017,10 +1019,6 @@ void CustomHousesRoofRemove( Core::PKTBI_D7* msg )
 
 void CustomHousesSendFull( UHouse* house, Network::Client* client, int design )
 {
-  u32 clen;
-  u32 ulen;
-  unsigned char* data;
-  // unsigned char** stored_packet;
   std::vector<u8>* stored_packet;
 
   u32 planeheader = 0;
@@ -1064,13 +1062,21 @@ void CustomHousesSendFull( UHouse* house, Network::Client* client, int design )
     return;
   }
 
-  // create compressed house message
+  // create compressed house message, only planes changed since the last message get recompressed
 
   unsigned char planes = pdesign->NumUsedPlanes();
-  unsigned long sbuflen =
-      ( (unsigned long)( ( (float)( pdesign->TotalSize() * BYTES_PER_TILE ) ) * 1.001f ) + 12 );
-  sbuflen += planes * BYTES_PER_TILE;  // for plane header dword
-  sbuflen += 17;                       // for packet header
+  const std::vector<u8>* plane_data[CUSTOM_HOUSE_NUM_PLANES];
+  u32 plane_ulen[CUSTOM_HOUSE_NUM_PLANES];
+  size_t sbuflen = data_offset + 1;  // packet header and plane count
+  for ( int i = 0; i < planes; i++ )
+  {
+    plane_data[i] = pdesign->CompressedPlane( i, &plane_ulen[i] );
+    if ( plane_data[i] == nullptr )  // compression error
+      return;
+    sbuflen += 4;  // plane header dword
+    if ( plane_ulen[i] != 0 )
+      sbuflen += plane_data[i]->size();
+  }
 
   std::vector<u8> packet( sbuflen );
 
@@ -1088,13 +1094,8 @@ void CustomHousesSendFull( UHouse* house, Network::Client* client, int design )
   for ( int i = 0; i < planes; i++ )
   {
     planeheader = 0;
-    data = pdesign->Compress( i, &ulen, &clen );
-    if ( data == nullptr )  // compression error
-    {
-      return;
-    }
-    if ( ulen == 0 )
-      clen = 0;
+    u32 ulen = plane_ulen[i];
+    u32 clen = ulen == 0 ? 0 : static_cast<u32>( plane_data[i]->size() );
     planeheader |= ( ( mode << 4 ) << 24 );
     planeheader |= ( ( i & 0xF ) << 24 );
     planeheader |= ( ( ulen & 0xFF ) << 16 );
@@ -1103,9 +1104,9 @@ void CustomHousesSendFull( UHouse* house, Network::Client* client, int design )
     u32* p_planeheader = reinterpret_cast<u32*>( &( packet[buffer_len + data_offset] ) );
     *p_planeheader = ctBEu32( planeheader );
     buffer_len += 4;
-    memcpy( &( packet[buffer_len + data_offset] ), data, clen );
+    if ( clen != 0 )
+      memcpy( &( packet[buffer_len + data_offset] ), plane_data[i]->data(), clen );
     buffer_len += clen;
-    delete[] data;
   }
   msg->msglen = ctBEu16( static_cast<u16>( buffer_len ) + data_offset );
   msg->planebuffer_len = ctBEu16( static_cast<u16>( buffer_len ) );
@@ -122,7 +122,8 @@ public:
   void Clear();
   bool IsEmpty() const;
 
-  unsigned char* Compress( int floor, u32* uncompr_length, u32* compr_length );
+  // zlib compressed plane data, recompressed only if the plane changed since the last call
+  const std::vector<u8>* CompressedPlane( int floor, u32* uncompr_length );
 
   unsigned int TotalSize() const;
   unsigned char NumUsedPlanes() const;
@@ -153,6 +154,16 @@ public:
   Bscript::ObjArray* list_parts() const;
 
 private:
+  struct PlaneCache
+  {
+    std::vector<u8> data;
+    u32 uncompr_length = 0;
+    bool valid = false;
+  };
+  PlaneCache compressed_planes[CUSTOM_HOUSE_NUM_PLANES];
+
+  void PlaneChanged( int floor ) { compressed_planes[floor].valid = false; }
+  bool Compress( int floor, std::vector<u8>& compressed, u32* uncompr_length ) const;
   bool isEditableItem( UHouse* house, Items::Item* item );
   static char z_to_custom_house_table( char z );
 };
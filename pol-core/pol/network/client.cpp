@@ -99,7 +99,8 @@ ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient,
       first_xmit_buffer( nullptr ),
       last_xmit_buffer( nullptr ),
       n_queued( 0 ),
-      queued_bytes_counter( 0 )
+      queued_bytes_counter( 0 ),
+      coalesced_xmit()
 {
   memset( &counters, 0, sizeof counters );
   memcpy( &ipaddr, &client_addr, sizeof ipaddr );
@@ -436,7 +437,9 @@ std::string Client::status() const
   st += ipaddrAsString() + " ";
   st += "CHK: " + Clib::tostring( checkpoint ) + " ";
   st += "PID: " + Clib::tostring( thread_pid ) + " ";
-  st += "LAST: " + Clib::hexint( last_msgtype );
+  st += "LAST: " + Clib::hexint( last_msgtype ) + " ";
+  st += "SENDS: " + Clib::tostring( counters.send_calls ) + "/" +
+        Clib::tostring( counters.bytes_transmitted );
   return st;
 }
 
@@ -478,7 +481,7 @@ void ThreadedClient::queue_data( const void* data, unsigned short datalen )
   THREAD_CHECKPOINT( active_client, 309 );
 }
 
-void ThreadedClient::xmit( const void* data, unsigned short datalen )
+void ThreadedClient::xmit( const void* data, unsigned short datalen, bool coalesce )
 {
   if ( csocket == INVALID_SOCKET )
     return;
@@ -489,6 +492,45 @@ void ThreadedClient::xmit( const void* data, unsigned short datalen )
     this->cryptengine->Encrypt( (void*)data, (void*)data, datalen );
   }
   THREAD_CHECKPOINT( active_client, 200 );
+  const size_t coalesce_size = Core::networkManager.uoclient_protocol.CoalesceSendBytes;
+  if ( coalesce && coalesce_size )
+  {
+    // keep collecting till the transmit batch ends or enough data is available
+    if ( coalesced_xmit.size() + datalen > 0xFFFF )
+    {
+      send_data( coalesced_xmit.data(), static_cast<unsigned short>( coalesced_xmit.size() ) );
+      coalesced_xmit.clear();
+    }
+    const unsigned char* cdata = (const unsigned char*)data;
+    coalesced_xmit.insert( coalesced_xmit.end(), cdata, cdata + datalen );
+    if ( coalesced_xmit.size() >= coalesce_size )
+    {
+      send_data( coalesced_xmit.data(), static_cast<unsigned short>( coalesced_xmit.size() ) );
+      coalesced_xmit.clear();
+    }
+    return;
+  }
+  if ( !coalesced_xmit.empty() )  // keep the order
+  {
+    send_data( coalesced_xmit.data(), static_cast<unsigned short>( coalesced_xmit.size() ) );
+    coalesced_xmit.clear();
+  }
+  send_data( data, datalen );
+}
+
+/// Sends the data collected during the last transmit batch
+void ThreadedClient::flush_xmit()
+{
+  std::lock_guard<std::mutex> lock( _socketMutex );
+  if ( coalesced_xmit.empty() )
+    return;
+  if ( csocket != INVALID_SOCKET )
+    send_data( coalesced_xmit.data(), static_cast<unsigned short>( coalesced_xmit.size() ) );
+  coalesced_xmit.clear();
+}
+
+void ThreadedClient::send_data( const void* data, unsigned short datalen )
+{
   if ( last_xmit_buffer )  // this client already backlogged, schedule for later
   {
     THREAD_CHECKPOINT( active_client, 201 );
@@ -502,6 +544,8 @@ void ThreadedClient::xmit( const void* data, unsigned short datalen )
   const unsigned char* cdata = (const unsigned char*)data;
   int nsent;
 
+  ++counters.send_calls;
+  ++Core::networkManager.iostats.sends.calls;
   if ( -1 == ( nsent = send( csocket, (const char*)cdata, datalen, 0 ) ) )
   {
     THREAD_CHECKPOINT( active_client, 204 );
@@ -533,6 +577,7 @@ void ThreadedClient::xmit( const void* data, unsigned short datalen )
     THREAD_CHECKPOINT( active_client, 210 );
     datalen -= static_cast<unsigned short>( nsent );
     counters.bytes_transmitted += nsent;
+    Core::networkManager.iostats.sends.bytes += nsent;
     Core::networkManager.polstats.bytes_sent += nsent;
     if ( datalen )  // anything left? if so, queue for later.
     {
@@ -555,6 +600,8 @@ void ThreadedClient::send_queued_data()
   while ( nullptr != ( xbuffer = first_xmit_buffer ) )
   {
     int nsent;
+    ++counters.send_calls;
+    ++Core::networkManager.iostats.sends.calls;
     nsent = send( csocket, (char*)&xbuffer->data[xbuffer->nsent], xbuffer->lenleft, 0 );
     if ( nsent == -1 )
     {
@@ -582,6 +629,7 @@ void ThreadedClient::send_queued_data()
       xbuffer->nsent += static_cast<unsigned short>( nsent );
       xbuffer->lenleft -= static_cast<unsigned short>( nsent );
       counters.bytes_transmitted += nsent;
+      Core::networkManager.iostats.sends.bytes += nsent;
       Core::networkManager.polstats.bytes_sent += nsent;
       if ( xbuffer->lenleft == 0 )
       {
@@ -753,7 +801,8 @@ size_t Client::estimatedSize() const
 
 size_t ThreadedClient::estimatedSize() const
 {
-  size_t size = sizeof( ThreadedClient ) + Clib::memsize( allowed_proxies ) + fpLog.capacity();
+  size_t size = sizeof( ThreadedClient ) + Clib::memsize( allowed_proxies ) + fpLog.capacity() +
+                coalesced_xmit.capacity();
   Core::XmitBuffer* buffer_size = first_xmit_buffer;
   while ( buffer_size != nullptr )
   {
@@ -29,6 +29,7 @@
 #include <mutex>
 #include <queue>
 #include <string>
+#include <vector>
 
 #include "../../clib/network/sockets.h"
 #include "../../clib/rawtypes.h"
@@ -155,6 +156,7 @@ public:
   // methods below should be protected?
   bool have_queued_data() const;
   void send_queued_data();
+  void flush_xmit();
 
   void recv_remaining( int total_expected );
   void recv_remaining_nocrypt( int total_expected );
@@ -228,18 +230,21 @@ protected:
   Core::XmitBuffer* last_xmit_buffer;
   int n_queued;
   int queued_bytes_counter;  // only used for monitoring
+  // already encrypted data of the current transmit batch, see flush_xmit()
+  std::vector<unsigned char> coalesced_xmit;
 
   // we may want to track how many bytes total are outstanding,
   // and boot clients that are too far behind.
   void queue_data( const void* data, unsigned short datalen );
   void transmit_encrypted( const void* data, int len );
-  void xmit( const void* data, unsigned short datalen );
+  void xmit( const void* data, unsigned short datalen, bool coalesce = false );
+  void send_data( const void* data, unsigned short datalen );
 
-private:
   struct
   {
     unsigned int bytes_transmitted;
     unsigned int bytes_received;
+    unsigned int send_calls;
   } counters;
 };
 
@@ -276,6 +281,7 @@ public:
   bool isConnected() const { return session()->isConnected(); }
   bool isReallyConnected() const { return session()->isReallyConnected(); }
   void forceDisconnect() { session()->forceDisconnect(); }
+  void flush_xmit() { session()->flush_xmit(); }
 
   Core::polclock_t last_activity_at() { return session()->last_activity_at; }
   Core::polclock_t last_packet_at() { return session()->last_packet_at; }
@@ -238,8 +238,10 @@ void ThreadedClient::transmit_encrypted( const void* data, int len )
   passert_always( pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) + 1 <=
                   int( sizeof outbuffer->buffer ) );
   THREAD_CHECKPOINT( active_client, 115 );
-  xmit( &outbuffer->buffer, static_cast<unsigned short>(
-                                pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) + 1 ) );
+  xmit( &outbuffer->buffer,
+        static_cast<unsigned short>( pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) +
+                                     1 ),
+        true );
   PktHelper::ReAddPacket( outbuffer );
   THREAD_CHECKPOINT( active_client, 116 );
 }
@@ -305,7 +307,7 @@ void Client::transmit( const void* data, int len )
   }
   else
   {
-    xmit( data, static_cast<unsigned short>( len ) );
+    xmit( data, static_cast<unsigned short>( len ), true );
     // _xmit( client->csocket, data, len );
   }
 }
@@ -14,11 +14,13 @@
 #include "../../clib/passert.h"
 #include "../../clib/spinlock.h"
 #include "../../clib/stlutil.h"
+#include "../../clib/timer.h"
 #include "../../plib/systemstate.h"
 #include "../accounts/account.h"
 #include "../clib/network/sockets.h"
 #include "../core.h"
 #include "../crypt/cryptbase.h"
+#include "../globals/state.h"
 #include "../mobile/charactr.h"
 #include "../polcfg.h"
 #include "../polclock.h"
@@ -752,6 +754,7 @@ void Client::handle_msg( unsigned char* pktbuffer, int pktlen )
   try
   {
     INFO_PRINTLN_TRACE( 10 )( "Client#{}: message {:#x}", instance_, msgtype );
+    Tools::LatencyTimer timer( Core::stateManager.tick_histograms.packet_handling );
 
     // TODO: use PacketRegistry::handle_msg(...) ?
     MSG_HANDLER packetHandler = Network::PacketRegistry::find_handler( msgtype, this );
@@ -1,5 +1,7 @@
 #include "clienttransmit.h"
 
+#include <algorithm>
+
 #include "../../clib/esignal.h"
 #include "../../clib/rawtypes.h"
 #include "../globals/network.h"
@@ -52,30 +54,62 @@ TransmitDataSPtr ClientTransmit::NextQueueEntry()
   return transmitdata;
 }
 
+void ClientTransmit::NextQueueEntries( std::list<TransmitDataSPtr>* entries )
+{
+  _transmitqueue.pop_wait( entries );
+}
+
+// Everything queued since the last wakeup is handled as one batch, the packets per client are
+// collected and sent with as few send() calls as possible at the end of the batch
 void ClientTransmitThread()
 {
   ClientTransmit* transmit_instance = Core::networkManager.clientTransmit.get();
+  std::list<TransmitDataSPtr> entries;
+  std::vector<weak_ptr<Client>> pending;
+  auto flush = [&]( Client* client )
+  {
+    client->flush_xmit();
+    pending.erase( std::remove_if( pending.begin(), pending.end(),
+                                   [&]( const weak_ptr<Client>& c )
+                                   { return c.get_weakptr() == client; } ),
+                   pending.end() );
+  };
   while ( !Clib::exit_signalled )
   {
     try
     {
-      auto data = transmit_instance->NextQueueEntry();
-      if ( data->client.exists() )
+      transmit_instance->NextQueueEntries( &entries );
+      for ( auto& data : entries )
       {
+        if ( !data->client.exists() )
+          continue;
         if ( data->remove )
         {
+          flush( data->client.get_weakptr() );
           Core::PolLock lock;
           delete data->client.get_weakptr();
         }
         else if ( data->disconnects )
         {
+          flush( data->client.get_weakptr() );
           data->client->forceDisconnect();
         }
         else if ( data->client->isReallyConnected() )
         {
           data->client->transmit( static_cast<void*>( &data->data[0] ), data->len );
+          if ( std::none_of( pending.begin(), pending.end(),
+                             [&]( const weak_ptr<Client>& c )
+                             { return c.get_weakptr() == data->client.get_weakptr(); } ) )
+            pending.push_back( data->client );
         }
       }
+      entries.clear();
+      for ( auto& client : pending )
+      {
+        if ( client.exists() )
+          client->flush_xmit();
+      }
+      pending.clear();
     }
     catch ( ClientTransmitQueue::Canceled& )
     {
@@ -1,6 +1,7 @@
 #ifndef CLIENTSEND_H
 #define CLIENTSEND_H
 
+#include <list>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -46,6 +47,7 @@ public:
   void Cancel();
 
   TransmitDataSPtr NextQueueEntry();
+  void NextQueueEntries( std::list<TransmitDataSPtr>* entries );
 
 private:
   ClientTransmitQueue _transmitqueue;
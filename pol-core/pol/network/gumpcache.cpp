@@ -0,0 +1,84 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "gumpcache.h"
+
+#include <zlib.h>
+
+#include "../globals/settings.h"
+
+namespace Pol
+{
+namespace Network
+{
+namespace
+{
+bool compress_section( const char* data, size_t len, std::vector<u8>& compressed )
+{
+  unsigned long cbuflen = compressBound( static_cast<unsigned long>( len ) );
+  compressed.resize( cbuflen );
+  if ( compress2( compressed.data(), &cbuflen, reinterpret_cast<const unsigned char*>( data ),
+                  static_cast<unsigned long>( len ), Z_DEFAULT_COMPRESSION ) != Z_OK )
+    return false;
+  compressed.resize( cbuflen );
+  return true;
+}
+}  // namespace
+
+GumpCache::GumpCache() : _entries(), _index(), _uncached() {}
+
+const std::vector<u8>* GumpCache::compress( const char* data, size_t len )
+{
+  auto itr = _index.find( std::string_view( data, len ) );
+  if ( itr != _index.end() )
+  {
+    _entries.splice( _entries.begin(), _entries, itr->second );
+    return &itr->second->compressed;
+  }
+
+  const size_t max_size = Core::settingsManager.ssopt.gump_cache_size;
+  if ( !max_size )
+  {
+    if ( !compress_section( data, len, _uncached ) )
+      return nullptr;
+    return &_uncached;
+  }
+
+  Entry entry{ std::string( data, len ), {} };
+  if ( !compress_section( data, len, entry.compressed ) )
+    return nullptr;
+  entry.compressed.shrink_to_fit();
+  while ( _entries.size() >= max_size )
+  {
+    _index.erase( _entries.back().content );
+    _entries.pop_back();
+  }
+  _entries.push_front( std::move( entry ) );
+  _index.emplace( _entries.front().content, _entries.begin() );
+  return &_entries.front().compressed;
+}
+
+void GumpCache::clear()
+{
+  _index.clear();
+  _entries.clear();
+  _uncached.clear();
+  _uncached.shrink_to_fit();
+}
+
+size_t GumpCache::estimateSize() const
+{
+  size_t size = sizeof( GumpCache ) + _uncached.capacity();
+  for ( const auto& entry : _entries )
+    size += sizeof( Entry ) + 2 * sizeof( void* ) + entry.content.capacity() +
+            entry.compressed.capacity();
+  size += _index.size() * ( sizeof( std::string_view ) + sizeof( EntryList::iterator ) +
+                            sizeof( void* ) ) +
+          _index.bucket_count() * sizeof( void* );
+  return size;
+}
+}  // namespace Network
+}  // namespace Pol
@@ -0,0 +1,58 @@
+/** @file
+ *
+ * @par History
+ */
+
+#ifndef __GUMPCACHE_H
+#define __GUMPCACHE_H
+
+#include <list>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Network
+{
+/**
+ * LRU cache of zlib compressed gump layouts (0xDD), keyed by the uncompressed layout.
+ *
+ * Dialogs like shop, status or help gumps are sent with the same layout to every player, the
+ * layout gets compressed only once and afterwards copied from the cache.
+ * The maximum number of entries is defined by ServSpecOpt GumpCacheSize, 0 disables the cache.
+ */
+class GumpCache
+{
+public:
+  GumpCache();
+  GumpCache( const GumpCache& ) = delete;
+  GumpCache& operator=( const GumpCache& ) = delete;
+
+  // returns the compressed data, nullptr on compression error
+  // valid until the next call
+  const std::vector<u8>* compress( const char* data, size_t len );
+  void clear();
+
+  size_t estimateSize() const;
+
+private:
+  struct Entry
+  {
+    std::string content;
+    std::vector<u8> compressed;
+  };
+  typedef std::list<Entry> EntryList;
+
+  // most recently used entry is at the front, keys point into Entry::content
+  EntryList _entries;
+  std::unordered_map<std::string_view, EntryList::iterator> _index;
+  std::vector<u8> _uncached;
+};
+}  // namespace Network
+}  // namespace Pol
+#endif
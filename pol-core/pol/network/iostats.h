@@ -14,16 +14,22 @@ namespace Network
 class IOStats
 {
 public:
-  IOStats();
-
   struct Packet
   {
-    std::atomic<unsigned int> count;
-    std::atomic<unsigned int> bytes;
+    std::atomic<unsigned int> count{ 0 };
+    std::atomic<unsigned int> bytes{ 0 };
+  };
+
+  // send() calls to the sockets layer
+  struct Sends
+  {
+    std::atomic<unsigned int> calls{ 0 };
+    std::atomic<unsigned int> bytes{ 0 };
   };
 
   Packet sent[256];
   Packet received[256];
+  Sends sends;
 };
 }
 }
@@ -272,6 +272,11 @@ void ObjectHash::RegisterCleanDeletedSerial( u32 serial )
 {
   clean_deleted.insert( serial );
 }
+
+void ObjectHash::RegisterDirtyDeletedSerial( u32 serial )
+{
+  dirty_deleted.insert( serial );
+}
 size_t ObjectHash::estimateSize() const
 {
   size_t size = sizeof( ObjectHash );
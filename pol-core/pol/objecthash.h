@@ -71,6 +71,7 @@ public:
   void ClearDeleted();
 
   void RegisterCleanDeletedSerial( u32 serial );
+  void RegisterDirtyDeletedSerial( u32 serial );
 
   size_t estimateSize() const;
 
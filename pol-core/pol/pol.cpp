@@ -533,6 +533,7 @@ void tasks_thread( void )
       THREAD_CHECKPOINT( tasks, 1 );
       {
         PolLock lck;
+        Tools::LatencyTimer pass_timer( stateManager.tick_histograms.tasks_pass );
         polclock_checkin();
         THREAD_CHECKPOINT( tasks, 2 );
         INC_PROFILEVAR( scheduler_passes );
@@ -585,6 +586,7 @@ void scripts_thread( void )
     THREAD_CHECKPOINT( scripts, 0 );
     {
       PolLock lck;
+      Tools::LatencyTimer pass_timer( stateManager.tick_histograms.scripts_pass );
       polclock_checkin();
       TRACEBUF_ADDELEM( "scripts thread now", static_cast<u32>( polclock() ) );
       ++stateManager.profilevars.script_passes;
@@ -1216,7 +1218,12 @@ int xmain_inner( bool testing )
       Core::write_data( dirty, clean, elapsed_ms );
     else
       Core::save_incremental( dirty, clean, elapsed_ms );
-    Core::SaveContext::ready();
+    if ( !Core::SaveContext::ready() )
+    {
+      // a failed forked save, this one is done without fork
+      Core::write_data( dirty, clean, elapsed_ms );
+      Core::SaveContext::ready();
+    }
     POLLOG_INFOLN( "Data save completed in {} ms. {} total.", elapsed_ms, timer.ellapsed() );
   }
   else
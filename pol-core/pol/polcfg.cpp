@@ -118,6 +118,16 @@ void PolConfig::read_pol_config( bool initial_load )
   Plib::systemstate.config.watch_sysload = elem.remove_bool( "WatchSysLoad", false );
   Plib::systemstate.config.log_sysload = elem.remove_bool( "LogSysLoad", false );
   Plib::systemstate.config.inhibit_saves = elem.remove_bool( "InhibitSaves", false );
+  Plib::systemstate.config.fork_worldsave = elem.remove_bool( "ForkWorldSave", false );
+  Plib::systemstate.config.fork_worldsave_timeout =
+      elem.remove_ulong( "ForkWorldSaveTimeout", 600 );
+#ifdef _WIN32
+  if ( Plib::systemstate.config.fork_worldsave )
+  {
+    POLLOG_ERRORLN( "pol.cfg ForkWorldSave is not supported on Windows" );
+    Plib::systemstate.config.fork_worldsave = false;
+  }
+#endif
   Plib::systemstate.config.log_script_cycles = elem.remove_bool( "LogScriptCycles", false );
   Plib::systemstate.config.web_server_local_only = elem.remove_bool( "WebServerLocalOnly", true );
   Plib::systemstate.config.web_server_debug = elem.remove_ushort( "WebServerDebug", 0 );
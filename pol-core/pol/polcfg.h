@@ -39,6 +39,8 @@ struct PolConfig
   bool watch_mapcache;
   bool check_integrity;
   bool inhibit_saves;
+  bool fork_worldsave;
+  unsigned int fork_worldsave_timeout;  // seconds
   bool log_script_cycles;
   bool count_resource_tiles;
   bool web_server;
@@ -11,7 +11,9 @@
 #include "../clib/logfacility.h"
 #include "../clib/passert.h"
 #include "../clib/threadhelp.h"
+#include "../clib/timer.h"
 #include "../clib/tracebuf.h"
+#include "globals/state.h"
 
 #ifdef _WIN32
 #include <process.h>
@@ -25,19 +27,38 @@ namespace Pol
 namespace Core
 {
 size_t locker;
+// guarded by the lock itself
+static Tools::HighPerfTimer::Clock::time_point locked_at;
+
+static void record_lock_wait( Tools::HighPerfTimer::Clock::time_point wait_start )
+{
+  locked_at = Tools::HighPerfTimer::Clock::now();
+  stateManager.tick_histograms.pollock_wait.record(
+      std::chrono::duration_cast<Tools::LatencyHistogram::time_mu>( locked_at - wait_start ) );
+}
+
+static void record_lock_hold()
+{
+  stateManager.tick_histograms.pollock_hold.record(
+      std::chrono::duration_cast<Tools::LatencyHistogram::time_mu>(
+          Tools::HighPerfTimer::Clock::now() - locked_at ) );
+}
 #ifdef _WIN32
 void polsem_lock()
 {
   size_t tid = threadhelp::thread_pid();
+  auto wait_start = Tools::HighPerfTimer::Clock::now();
   EnterCriticalSection( &cs );
   passert_always( locker == 0 );
   locker = tid;
+  record_lock_wait( wait_start );
 }
 
 void polsem_unlock()
 {
   size_t tid = GetCurrentThreadId();
   passert_always( locker == tid );
+  record_lock_hold();
   locker = 0;
   LeaveCriticalSection( &cs );
 }
@@ -45,6 +66,7 @@ void polsem_unlock()
 void polsem_lock()
 {
   size_t tid = threadhelp::thread_pid();
+  auto wait_start = Tools::HighPerfTimer::Clock::now();
   int res = pthread_mutex_lock( &polsem );
   if ( res != 0 || locker != 0 )
   {
@@ -53,11 +75,13 @@ void polsem_lock()
   passert_always( res == 0 );
   passert_always( locker == 0 );
   locker = tid;
+  record_lock_wait( wait_start );
 }
 void polsem_unlock()
 {
   size_t tid = threadhelp::thread_pid();
   passert_always( locker == tid );
+  record_lock_hold();
   locker = 0;
   int res = pthread_mutex_unlock( &polsem );
   if ( res != 0 )
@@ -18,7 +18,9 @@
 #include <ctype.h>
 #include <errno.h>
 #include <iosfwd>
+#include <iterator>
 #include <string>
+#include <utility>
 #include <time.h>
 
 #include "../clib/cfgelem.h"
@@ -38,6 +40,7 @@
 #include "../plib/pkg.h"
 #include "../plib/systemstate.h"
 
+#include "globals/state.h"
 #include "globals/uvars.h"
 #include "module/httpmod.h"
 #include "module/uomod.h"
@@ -743,6 +746,48 @@ void send_binary( Clib::Socket& sck, const std::string& page, const std::string&
   }
 }
 
+// latency histograms in prometheus text format, needs no script and no world lock
+void send_metrics( Clib::Socket& sck )
+{
+  const auto& hist = stateManager.tick_histograms;
+  const std::pair<const char*, const Tools::LatencyHistogram*> metrics[] = {
+      { "scripts_pass", &hist.scripts_pass },
+      { "tasks_pass", &hist.tasks_pass },
+      { "script_start", &hist.script_start },
+      { "script_teardown", &hist.script_teardown },
+      { "pollock_wait", &hist.pollock_wait },
+      { "pollock_hold", &hist.pollock_hold },
+      { "packet_handling", &hist.packet_handling },
+      { "worldsave_blocking", &hist.worldsave_blocking },
+      { "worldsave_total", &hist.worldsave_total },
+      { "worldsave_incremental", &hist.worldsave_incremental } };
+
+  std::string body;
+  for ( const auto& [name, histogram] : metrics )
+    histogram->write_prometheus( body, fmt::format( "pol_{}", name ),
+                                 fmt::format( "{} duration", name ) );
+
+  // precalculated quantiles for those without a prometheus server
+  body +=
+      "# HELP pol_latency_quantile_seconds estimated quantiles of the histograms\n"
+      "# TYPE pol_latency_quantile_seconds gauge\n";
+  for ( const auto& [name, histogram] : metrics )
+  {
+    for ( double q : { 0.5, 0.99, 0.999 } )
+    {
+      fmt::format_to( std::back_inserter( body ),
+                      "pol_latency_quantile_seconds{{histogram=\"{}\",quantile=\"{}\"}} {}\n",
+                      name, q, histogram->quantile( q ).count() / 1e6 );
+    }
+  }
+
+  http_writeline( sck, "HTTP/1.1 200 OK" );
+  http_writeline( sck, "Content-Type: text/plain; version=0.0.4" );
+  http_writeline( sck, "Content-Length: " + Clib::tostring( body.size() ) );
+  http_writeline( sck, "" );
+  sck.send( body.c_str(), static_cast<unsigned int>( body.size() ) );
+}
+
 void http_func( SOCKET client_socket )
 {
   Clib::Socket sck( client_socket );
@@ -872,6 +917,12 @@ void http_func( SOCKET client_socket )
     return;
   }
 
+  if ( page == "/metrics" )
+  {
+    send_metrics( sck );
+    return;
+  }
+
 
   Plib::Package* pkg = nullptr;
   std::string filename;
@@ -7,10 +7,14 @@
 
 #include "proplist.h"
 
+#include <cmath>
 #include <stddef.h>
+#include <typeinfo>
 
 #include "../bscript/berror.h"
 #include "../bscript/bobject.h"
+#include "../bscript/bstruct.h"
+#include "../bscript/dict.h"
 #include "../bscript/executor.h"
 #include "../bscript/impstr.h"
 #include "../bscript/objmethods.h"
@@ -315,6 +319,96 @@ size_t CPropProfiler::estimateSize() const
   return ret;
 }
 
+namespace
+{
+/**
+ * Returns true if unpack( value.pack() ) recreates exactly the given value, only those values are
+ * stored decoded. Everything else (object references, errors, ...) keeps the old behaviour of
+ * being packed on write.
+ */
+bool is_plain_value( const Bscript::BObjectImp& value )
+{
+  using namespace Bscript;
+  const std::type_info& type = typeid( value );
+  if ( type == typeid( BLong ) || type == typeid( String ) || type == typeid( BBoolean ) )
+    return true;
+  if ( type == typeid( Double ) )
+    return std::isfinite( static_cast<const Double&>( value ).value() );
+  if ( type == typeid( ObjArray ) )
+  {
+    const auto& arr = static_cast<const ObjArray&>( value );
+    if ( !arr.name_arr.empty() )
+      return false;
+    for ( const auto& elem : arr.ref_arr )
+    {
+      if ( elem.get() == nullptr || !is_plain_value( *elem->impptr() ) )
+        return false;
+    }
+    return true;
+  }
+  if ( type == typeid( BStruct ) )
+  {
+    for ( const auto& [key, member] : static_cast<const BStruct&>( value ).contents() )
+    {
+      if ( !is_plain_value( *member->impptr() ) )
+        return false;
+    }
+    return true;
+  }
+  if ( type == typeid( BDictionary ) )
+  {
+    for ( const auto& [key, member] : static_cast<const BDictionary&>( value ).contents() )
+    {
+      if ( !is_plain_value( *key.impptr() ) || !is_plain_value( *member->impptr() ) )
+        return false;
+    }
+    return true;
+  }
+  return false;
+}
+}  // namespace
+
+PropertyList::PropValue::PropValue( const std::string& packed )
+    : _packed( packed ), _decoded(), _has_packed( true )
+{
+}
+
+PropertyList::PropValue::PropValue( ref_ptr<Bscript::BObjectImp> decoded )
+    : _packed(), _decoded( std::move( decoded ) ), _has_packed( false )
+{
+}
+
+PropertyList::PropValue::PropValue( const PropValue& ) = default;
+PropertyList::PropValue& PropertyList::PropValue::operator=( const PropValue& ) = default;
+PropertyList::PropValue::~PropValue() = default;
+
+const boost_utils::cprop_value_flystring& PropertyList::PropValue::packed() const
+{
+  if ( !_has_packed )
+  {
+    _packed = _decoded->pack();
+    _has_packed = true;
+  }
+  return _packed;
+}
+
+const Bscript::BObjectImp& PropertyList::PropValue::decoded() const
+{
+  if ( _decoded == nullptr )
+    _decoded.set( Bscript::BObjectImp::unpack( _packed.get().c_str() ) );
+  return *_decoded;
+}
+
+bool PropertyList::PropValue::operator==( const PropValue& other ) const
+{
+  return packed() == other.packed();
+}
+
+size_t PropertyList::PropValue::sizeEstimate() const
+{
+  return sizeof( PropValue ) + ( _decoded != nullptr ? _decoded->sizeEstimate() : 0 );
+}
+
 /**
  * Initialize and register this property list based on a given type
  * register only if the profile_cprops flag is set
@@ -349,7 +443,7 @@ PropertyList::PropertyList( const PropertyList& props ) : properties()
 size_t PropertyList::estimatedSize() const
 {
   size_t size = sizeof( PropertyList );
-  size += Clib::memsize( properties );
+  size += Clib::memsize( properties, []( const PropValue& v ) { return v.sizeEstimate(); } );
   return size;
 }
 
@@ -365,7 +459,7 @@ bool PropertyList::getprop( const std::string& propname, std::string& propval )
   }
   else
   {
-    propval = ( *itr ).second;
+    propval = itr->second.packed();
     return true;
   }
 }
@@ -374,7 +468,36 @@ void PropertyList::setprop( const std::string& propname, const std::string& prop
   if ( Plib::systemstate.config.profile_cprops )
     CPropProfiler::instance().cpropWrite( this, propname );
 
-  properties[boost_utils::cprop_name_flystring( propname )] = propvalue;
+  properties.insert_or_assign( boost_utils::cprop_name_flystring( propname ),
+                               PropValue( propvalue ) );
+}
+
+/**
+ * Returns a new copy of the property value or nullptr if it does not exist
+ */
+Bscript::BObjectImp* PropertyList::getpropimp( const std::string& propname ) const
+{
+  if ( Plib::systemstate.config.profile_cprops )
+    CPropProfiler::instance().cpropRead( this, propname );
+
+  Properties::const_iterator itr = properties.find( boost_utils::cprop_name_flystring( propname ) );
+  if ( itr == properties.end() )
+    return nullptr;
+  return itr->second.decoded().copy();
+}
+
+void PropertyList::setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue )
+{
+  if ( !is_plain_value( propvalue ) )
+  {
+    setprop( propname, propvalue.pack() );
+    return;
+  }
+  if ( Plib::systemstate.config.profile_cprops )
+    CPropProfiler::instance().cpropWrite( this, propname );
+
+  properties.insert_or_assign( boost_utils::cprop_name_flystring( propname ),
+                               PropValue( ref_ptr<Bscript::BObjectImp>( propvalue.copy() ) ) );
 }
 
 void PropertyList::eraseprop( const std::string& propname )
@@ -418,7 +541,7 @@ void PropertyList::printProperties( Clib::StreamWriter& sw ) const
     const std::string& first = prop.first;
     if ( first[0] != '#' )
     {
-      sw.add( "CProp", fmt::format( "{} {}", first, prop.second.get() ) );
+      sw.add( "CProp", fmt::format( "{} {}", first, prop.second.packed().get() ) );
     }
   }
 }
@@ -429,7 +552,7 @@ void PropertyList::printProperties( Clib::ConfigElem& elem ) const
     const std::string& first = prop.first;
     if ( first[0] != '#' )
     {
-      elem.add_prop( "CProp", ( first + "\t" + prop.second.get() ) );
+      elem.add_prop( "CProp", ( first + "\t" + prop.second.packed().get() ) );
     }
   }
 }
@@ -441,7 +564,7 @@ void PropertyList::printPropertiesAsStrings( Clib::StreamWriter& sw ) const
     const std::string& first = prop.first;
     if ( first[0] != '#' )
     {
-      sw.add( first, prop.second.get() );
+      sw.add( first, prop.second.packed().get() );
     }
   }
 }
@@ -515,11 +638,10 @@ Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const in
     const String* propname_str;
     if ( !ex.getStringParam( 0, propname_str ) )
       return new BError( "Invalid parameter type" );
-    std::string val;
-    if ( !proplist.getprop( propname_str->value(), val ) )
+    BObjectImp* val = proplist.getpropimp( propname_str->value() );
+    if ( val == nullptr )
       return new BError( "Property not found" );
-
-    return Bscript::BObjectImp::unpack( val.c_str() );
+    return val;
   }
 
   case MTH_SETPROP:
@@ -536,7 +658,7 @@ Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const in
       POLLOGLN( "wtf, setprop w/ an error '{}' PC:{}", ex.scriptname().c_str(), ex.PC );
     }
     std::string propname = propname_str->value();
-    proplist.setprop( propname, propval->pack() );
+    proplist.setpropimp( propname, *propval );
     if ( propname[0] != '#' )
       changed = true;
     return new BLong( 1 );
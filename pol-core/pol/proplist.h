@@ -19,6 +19,7 @@
 
 #include "../clib/boostutils.h"
 #include "../clib/rawtypes.h"
+#include "../clib/refptr.h"
 #include "../clib/spinlock.h"
 
 namespace Pol
@@ -137,6 +138,9 @@ public:
   PropertyList( const PropertyList& );  // dave added 1/26/3
   bool getprop( const std::string& propname, std::string& propvalue ) const;
   void setprop( const std::string& propname, const std::string& propvalue );
+  // decoded variants, avoid the pack/unpack round trip for script values
+  Bscript::BObjectImp* getpropimp( const std::string& propname ) const;
+  void setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue );
   void eraseprop( const std::string& propname );
   void copyprops( const PropertyList& proplist );
   void getpropnames( std::vector<std::string>& propnames ) const;
@@ -154,8 +158,31 @@ public:
   PropertyList& operator-( const std::set<std::string>& );  // dave added 1/26/3
   void operator-=( const std::set<std::string>& );          // dave added 1/26/3
 protected:
-  typedef std::map<boost_utils::cprop_name_flystring, boost_utils::cprop_value_flystring>
-      Properties;
+  /**
+   * Value of a CProp, either in its packed form (as stored in the datafiles) or decoded or both.
+   * The missing form gets created and cached on first demand, the decoded value is never
+   * modified in place: readers get a copy and writers replace the whole value.
+   */
+  class PropValue
+  {
+  public:
+    explicit PropValue( const std::string& packed );
+    explicit PropValue( ref_ptr<Bscript::BObjectImp> decoded );
+    PropValue( const PropValue& );
+    PropValue& operator=( const PropValue& );
+    ~PropValue();
+
+    const boost_utils::cprop_value_flystring& packed() const;
+    const Bscript::BObjectImp& decoded() const;
+    bool operator==( const PropValue& other ) const;
+    size_t sizeEstimate() const;
+
+  private:
+    mutable boost_utils::cprop_value_flystring _packed;
+    mutable ref_ptr<Bscript::BObjectImp> _decoded;
+    mutable bool _has_packed;
+  };
+  typedef std::map<boost_utils::cprop_name_flystring, PropValue> Properties;
 
   Properties properties;
 
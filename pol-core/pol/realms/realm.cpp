@@ -92,7 +92,8 @@ size_t Realm::sizeEstimate() const
   {
     const auto& gzone = getzone_grid( p );
     size += Clib::memsize( gzone.characters ) + Clib::memsize( gzone.npcs ) +
-            Clib::memsize( gzone.items ) + Clib::memsize( gzone.multis );
+            Clib::memsize( gzone.items ) + Clib::memsize( gzone.multis ) +
+            gzone.decay_queue.sizeEstimate();
   }
 
   size += Clib::memsize( global_hulls );
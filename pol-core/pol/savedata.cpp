@@ -10,6 +10,7 @@
 #include <cerrno>
 #include <exception>
 #include <fstream>
+#include <mutex>
 
 #include "../clib/clib_endian.h"
 #include "../clib/fileutil.h"
@@ -21,6 +22,7 @@
 #include "../clib/timer.h"
 #include "../plib/systemstate.h"
 #include "globals/object_storage.h"
+#include "globals/state.h"
 #include "globals/uvars.h"
 #include "item/item.h"
 #include "item/itemdesc.h"
@@ -57,6 +59,12 @@ namespace Core
 // which is the root item.
 //
 // all data goes into this one file.
+//
+// guilds are few and have no dirty tracking, so each incremental save also
+// writes the complete guild table to incr-guilds-N.txt.  At startup the
+// newest of these replaces guilds.txt.
+
+void write_guilds( Clib::StreamWriter& sw );
 
 void write_dirty_storage( Clib::StreamWriter& sw_data )
 {
@@ -240,8 +248,12 @@ int save_incremental( unsigned int& dirty, unsigned int& clean, long long& elaps
         "Incremental saves are disabled until the next full save, due to a previous incremental "
         "save failure (dirty flags are inconsistent)" );
 
+  SaveContext::collect_finished();
+
   try
   {
+    std::lock_guard<std::mutex> lock( objStorageManager.incremental_save_mutex );
+    Tools::LatencyTimer latency_timer( stateManager.tick_histograms.worldsave_incremental );
     Tools::Timer<> timer;
     objStorageManager.clean_objects = objStorageManager.dirty_objects = 0;
 
@@ -249,39 +261,53 @@ int save_incremental( unsigned int& dirty, unsigned int& clean, long long& elaps
     objStorageManager.deleted_serials.clear();
 
     std::ofstream ofs_data;
+    std::ofstream ofs_guilds;
     std::ofstream ofs_index;
 
     ofs_data.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+    ofs_guilds.exceptions( std::ios_base::failbit | std::ios_base::badbit );
     ofs_index.exceptions( std::ios_base::failbit | std::ios_base::badbit );
 
     unsigned save_index = objStorageManager.incremental_save_count + 1;
     std::string data_basename = "incr-data-" + Clib::tostring( save_index );
+    std::string guilds_basename = "incr-guilds-" + Clib::tostring( save_index );
     std::string index_basename = "incr-index-" + Clib::tostring( save_index );
     std::string data_pathname = Plib::systemstate.config.world_data_path + data_basename + ".ndt";
+    std::string guilds_pathname =
+        Plib::systemstate.config.world_data_path + guilds_basename + ".ndt";
     std::string index_pathname = Plib::systemstate.config.world_data_path + index_basename + ".ndt";
     Clib::open_file( ofs_data, data_pathname, std::ios::out );
+    Clib::open_file( ofs_guilds, guilds_pathname, std::ios::out );
     Clib::open_file( ofs_index, index_pathname, std::ios::out );
-    Clib::StreamWriter sw_data( &ofs_data );
-    write_system_data( sw_data );
-    write_global_properties( sw_data );
+    {
+      Clib::StreamWriter sw_data( &ofs_data );
+      write_system_data( sw_data );
+      write_global_properties( sw_data );
 
-    // TODO:
-    //  guilds
-    //  resources
-    //  datastore
+      // TODO:
+      //  resources
+      //  datastore
 
-    write_dirty_storage( sw_data );
-    write_dirty_data( sw_data );
+      write_dirty_storage( sw_data );
+      write_dirty_data( sw_data );
+    }
+    {
+      Clib::StreamWriter sw_guilds( &ofs_guilds );
+      write_guilds( sw_guilds );
+    }
 
     write_index( ofs_index );
 
     ofs_data.close();
+    ofs_guilds.close();
     ofs_index.close();
 
     objStorageManager.modified_serials.clear();
     objStorageManager.deleted_serials.clear();
 
+    // the index is committed last, its presence is what makes the save count at startup
     commit_incremental( data_basename );
+    commit_incremental( guilds_basename );
     commit_incremental( index_basename );
     ++objStorageManager.incremental_save_count;
 
@@ -304,10 +330,12 @@ void commit_incremental_saves()
   for ( unsigned save_index = 1;; ++save_index )
   {
     std::string data_basename = "incr-data-" + Clib::tostring( save_index );
+    std::string guilds_basename = "incr-guilds-" + Clib::tostring( save_index );
     std::string index_basename = "incr-index-" + Clib::tostring( save_index );
 
     bool res1 = commit( data_basename );
     bool res2 = commit( index_basename );
+    commit( guilds_basename );
     if ( res1 || res2 )
     {
       continue;
@@ -318,5 +346,41 @@ void commit_incremental_saves()
     }
   }
 }
+
+// commits the first count incremental saves, which a full save replaced, the following ones are
+// renumbered to start at 1 again
+void commit_incremental_saves( unsigned count )
+{
+  if ( count == 0 )
+    return;
+  for ( unsigned save_index = 1; save_index <= count; ++save_index )
+  {
+    commit( "incr-data-" + Clib::tostring( save_index ) );
+    commit( "incr-index-" + Clib::tostring( save_index ) );
+    commit( "incr-guilds-" + Clib::tostring( save_index ) );
+  }
+  for ( unsigned save_index = count + 1;; ++save_index )
+  {
+    bool any = false;
+    // the index is renamed last, its presence is what makes the save count at startup
+    for ( const char* part : { "incr-data-", "incr-guilds-", "incr-index-" } )
+    {
+      std::string from = Plib::systemstate.config.world_data_path + part +
+                         Clib::tostring( save_index ) + ".txt";
+      if ( !Clib::FileExists( from ) )
+        continue;
+      any = true;
+      std::string to = Plib::systemstate.config.world_data_path + part +
+                       Clib::tostring( save_index - count ) + ".txt";
+      if ( rename( from.c_str(), to.c_str() ) )
+      {
+        int err = errno;
+        POLLOG_ERRORLN( "Unable to rename {} to {}: {} ({})", from, to, strerror( err ), err );
+      }
+    }
+    if ( !any )
+      break;
+  }
+}
 }  // namespace Core
 }  // namespace Pol
@@ -56,7 +56,8 @@ public:
   SaveStrategy datastore;
   SaveStrategy party;
   static std::shared_future<bool> finished;
-  static void ready();
+  static bool ready();
+  static void collect_finished();
 };
 
 int save_incremental( unsigned int& dirty_writes, unsigned int& clean_objects,
@@ -68,6 +69,7 @@ void write_shadow_realms( Clib::StreamWriter& sw );
 
 bool commit( const std::string& basename );
 void commit_incremental_saves();
+void commit_incremental_saves( unsigned count );
 bool should_write_data();
 }  // namespace Core
 }  // namespace Pol
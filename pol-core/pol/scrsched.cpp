@@ -126,6 +126,7 @@ void step_scripts( polclock_t* clocksleft, bool* pactivity )
 
 void start_script( const char* filename, Bscript::BObjectImp* param0, Bscript::BObjectImp* param1 )
 {
+  Tools::LatencyTimer start_timer( stateManager.tick_histograms.script_start );
   Bscript::BObject bobj0( param0 );  // just to delete if it doesn't go somewhere else
   Bscript::BObject bobj1( param1 ? param1 : Bscript::UninitObject::create() );
 
@@ -155,6 +156,7 @@ void start_script( const char* filename, Bscript::BObjectImp* param0, Bscript::B
 // EXACTLY the same as start_script, except uses find_script2
 Module::UOExecutorModule* start_script( const ScriptDef& script, Bscript::BObjectImp* param )
 {
+  Tools::LatencyTimer start_timer( stateManager.tick_histograms.script_start );
   Bscript::BObject bobj(
       param ? param
             : Bscript::UninitObject::create() );  // just to delete if it doesn't go somewhere else
@@ -190,6 +192,7 @@ Module::UOExecutorModule* start_script( const ScriptDef& script, Bscript::BObjec
                                         Bscript::BObjectImp* param1, Bscript::BObjectImp* param2,
                                         Bscript::BObjectImp* param3 )
 {
+  Tools::LatencyTimer start_timer( stateManager.tick_histograms.script_start );
   Bscript::BObject bobj0( param0 );  // just to delete if it doesn't go somewhere else
   Bscript::BObject bobj1( param1 );
   Bscript::BObject bobj2( param2 ? param2 : Bscript::UninitObject::create() );
@@ -235,6 +238,7 @@ Module::UOExecutorModule* start_script( const ScriptDef& script, Bscript::BObjec
 Module::UOExecutorModule* start_script( ref_ptr<Bscript::EScriptProgram> program,
                                         Bscript::BObjectImp* param )
 {
+  Tools::LatencyTimer start_timer( stateManager.tick_histograms.script_start );
   Bscript::BObject bobj(
       param ? param
             : Bscript::UninitObject::create() );  // just to delete if it doesn't go somewhere else
@@ -256,27 +260,37 @@ Module::UOExecutorModule* start_script( ref_ptr<Bscript::EScriptProgram> program
   return uoemod;
 }
 
+namespace
+{
+template <class T>
+Bscript::ExecutorModule* create_exmod( Bscript::Executor& ex )
+{
+  return new T( static_cast<UOExecutor&>( ex ) );
+}
+}  // namespace
+
 void add_common_exmods( UOExecutor& ex )
 {
+  // most scripts use only a few of these, they get created when the program links them
   using namespace Module;
-  ex.addModule( new BasicExecutorModule( ex ) );
-  ex.addModule( new BasicIoExecutorModule( ex ) );
-  ex.addModule( new ClilocExecutorModule( ex ) );
-  ex.addModule( new MathExecutorModule( ex ) );
-  ex.addModule( new UtilExecutorModule( ex ) );
+  ex.addModule( "basic", &create_exmod<BasicExecutorModule> );
+  ex.addModule( "basicio", &create_exmod<BasicIoExecutorModule> );
+  ex.addModule( "cliloc", &create_exmod<ClilocExecutorModule> );
+  ex.addModule( "math", &create_exmod<MathExecutorModule> );
+  ex.addModule( "util", &create_exmod<UtilExecutorModule> );
   // ex.addModule( new FileExecutorModule( ex ) );
-  ex.addModule( new ConfigFileExecutorModule( ex ) );
-  ex.addModule( new UBoatExecutorModule( ex ) );
-  ex.addModule( new DataFileExecutorModule( ex ) );
-  ex.addModule( new PolSystemExecutorModule( ex ) );
-  ex.addModule( new AttributeExecutorModule( ex ) );
-  ex.addModule( new VitalExecutorModule( ex ) );
-  ex.addModule( new StorageExecutorModule( ex ) );
-  ex.addModule( new GuildExecutorModule( ex ) );
-  ex.addModule( new UnicodeExecutorModule( ex ) );
-  ex.addModule( new PartyExecutorModule( ex ) );
-  ex.addModule( new SQLExecutorModule( ex ) );
-  ex.addModule( CreateFileAccessExecutorModule( ex ) );
+  ex.addModule( "cfgfile", &create_exmod<ConfigFileExecutorModule> );
+  ex.addModule( "boat", &create_exmod<UBoatExecutorModule> );
+  ex.addModule( "datafile", &create_exmod<DataFileExecutorModule> );
+  ex.addModule( "polsys", &create_exmod<PolSystemExecutorModule> );
+  ex.addModule( "attributes", &create_exmod<AttributeExecutorModule> );
+  ex.addModule( "vitals", &create_exmod<VitalExecutorModule> );
+  ex.addModule( "storage", &create_exmod<StorageExecutorModule> );
+  ex.addModule( "guilds", &create_exmod<GuildExecutorModule> );
+  ex.addModule( "unicode", &create_exmod<UnicodeExecutorModule> );
+  ex.addModule( "party", &create_exmod<PartyExecutorModule> );
+  ex.addModule( "sql", &create_exmod<SQLExecutorModule> );
+  ex.addModule( "file", &CreateFileAccessExecutorModule );
 }
 
 bool run_script_to_completion_worker( UOExecutor& ex, Bscript::EScriptProgram* prog )
@@ -644,6 +658,7 @@ void schedule_executor( UOExecutor* ex )
   }
   else
   {
+    Tools::LatencyTimer teardown_timer( stateManager.tick_histograms.script_teardown );
     delete ex;
   }
 }
@@ -8,6 +8,7 @@
 #include "scrstore.h"
 
 #include "../bscript/eprog.h"
+#include "../bscript/scriptprofile.h"
 #include "../clib/logfacility.h"
 #include "../clib/rawtypes.h"
 #include "../clib/strutil.h"
@@ -18,6 +19,7 @@
 #include "profile.h"
 #include "scrdef.h"
 
+#include <fstream>
 #include <iterator>
 
 
@@ -183,6 +185,7 @@ void log_all_script_cycle_counts( bool clear_counters )
     {
       eprog->instr_cycles = 0;
       eprog->invocations = eprog->count() - 1;  // 1 count is the scrstore's
+      Bscript::ScriptProfile::clear( *eprog );
     }
   }
   POLLOG( tmp );
@@ -198,9 +201,29 @@ void clear_script_profile_counters()
     Bscript::EScriptProgram* eprog = scr.second.get();
     eprog->instr_cycles = 0;
     eprog->invocations = eprog->count() - 1;  // 1 count is the scrstore's
+    Bscript::ScriptProfile::clear( *eprog );
   }
 
   POLLOGLN( "Profiling counters cleared." );
 }
+
+bool log_script_profile_stacks( bool clear_samples )
+{
+  std::string tmp;
+  for ( const auto& scr : scriptScheduler.scrstore )
+  {
+    Bscript::EScriptProgram* eprog = scr.second.get();
+    Bscript::ScriptProfile::write_collapsed( *eprog, tmp );
+    if ( clear_samples )
+      Bscript::ScriptProfile::clear( *eprog );
+  }
+  // overwritten every time, the file is meant to be fed into flamegraph.pl as a whole
+  std::ofstream ofs( "log/scriptprofile.folded", std::ios::out | std::ios::trunc );
+  if ( !ofs )
+    return false;
+  ofs << tmp;
+  POLLOGLN( "Script profile stacks written to log/scriptprofile.folded." );
+  return static_cast<bool>( ofs );
+}
 }  // namespace Core
 }  // namespace Pol
@@ -35,6 +35,7 @@ int unload_script( const std::string& name );
 int unload_all_scripts();  // returns # of scripts unloaded
 void log_all_script_cycle_counts( bool clear_counters );
 void clear_script_profile_counters();
+bool log_script_profile_stacks( bool clear_samples );
 
 bool script_loaded( ScriptDef& sd );
 }
@@ -147,6 +147,8 @@ void ServSpecOpt::read_servspecopt()
   settingsManager.ssopt.boat_sails_collide = elem.remove_bool( "BoatSailsCollide", false );
   settingsManager.ssopt.npc_minimum_movement_delay =
       elem.remove_ushort( "NpcMinimumMovementDelay", 250 );
+  settingsManager.ssopt.tooltip_cache_size = elem.remove_ulong( "TooltipCacheSize", 10000 );
+  settingsManager.ssopt.gump_cache_size = elem.remove_ulong( "GumpCacheSize", 1000 );
 
   ssopt_parse_totalstats( elem );
 
@@ -107,6 +107,9 @@ struct ServSpecOpt
 
   unsigned short npc_minimum_movement_delay;
 
+  unsigned int tooltip_cache_size;
+  unsigned int gump_cache_size;
+
   static void read_servspecopt();
   static void ssopt_parse_totalstats( Clib::ConfigElem& elem );
 };
@@ -33,6 +33,7 @@ bool run_pol_tests()
   RUNTEST( test_convertquotedstring )
   RUNTEST( test_sanitizeUnicodeWithIso )
   RUNTEST( test_encodingconversions )
+  RUNTEST( configfile_test )
 
   //  skilladv_test();
 
@@ -42,6 +43,10 @@ bool run_pol_tests()
   //  map_test();
   RUNTEST( dynprops_test )
   RUNTEST( packet_test )
+  RUNTEST( latency_histogram_test )
+  RUNTEST( cprop_test )
+  RUNTEST( dictionary_test )
+  RUNTEST( executor_modules_test )
   RUNTEST( vector2d_test )
   RUNTEST( vector3d_test )
   RUNTEST( pos2d_test )
@@ -52,6 +57,7 @@ bool run_pol_tests()
 
   RUNTEST( test_curlfeatures )
 
+  RUNTEST( decay_queue_test )
   RUNTEST( decay_test )
   //  RUNTEST( dummy )
 
@@ -10,6 +10,9 @@
 
 #include "../../clib/logfacility.h"
 #include "../../clib/rawtypes.h"
+#include "../decay.h"
+#include "../fnsearch.h"
+#include "../gameclck.h"
 #include "../globals/uvars.h"
 #include "../item/item.h"
 #include "../polclock.h"
@@ -155,4 +158,63 @@ void decay_test()
   }
   UnitTest::inc_successes();
 }
+
+void decay_queue_test()
+{
+  using namespace std::chrono_literals;
+  INFO_PRINTLN( "    due order" );
+  Core::ZoneDecayQueue queue;
+  queue.push( 30, 1 );
+  queue.push( 10, 2 );
+  queue.push( 20, 3 );
+  UnitTest( [&]() { return queue.due( 10 ); }, false, "due(10)" );
+  UnitTest( [&]() { return queue.due( 11 ); }, true, "due(11)" );
+  UnitTest( [&]() { return queue.pop() == Core::ZoneDecayQueue::Entry{ 10, 2 }; }, true,
+            "pop 10" );
+  UnitTest( [&]() { return queue.due( 11 ); }, false, "due(11) after pop" );
+  UnitTest( [&]() { return queue.pop() == Core::ZoneDecayQueue::Entry{ 20, 3 }; }, true,
+            "pop 20" );
+  UnitTest( [&]() { return queue.pop() == Core::ZoneDecayQueue::Entry{ 30, 1 }; }, true,
+            "pop 30" );
+  UnitTest( [&]() { return queue.size(); }, 0u, "empty" );
+
+  // sweep only the zone of the item, without touching the state of the decay thread
+  auto* realm = Core::gamestate.Realms[0];
+  Core::Decay d;
+  d.realm_index = 0;
+  d.area = realm->gridarea();
+  d.area_itr = d.area.begin();
+  auto& zone = realm->getzone_grid( *d.area_itr );
+  zone.decay_queue.clear();
+
+  auto* item = Items::Item::create( 0x0eed );
+  item->setposition( { 0, 0, 0, realm } );
+  Core::add_item_to_world( item );
+  u32 serial = item->serial;
+  auto exists = [&]() { return Core::system_find_item( serial ) != nullptr; };
+
+  INFO_PRINTLN( "    outdated entry" );
+  item->set_decay_after( 1 );
+  item->set_decay_after( 60 );
+  Core::shift_clock_for_unittest( 2s );
+  d.decay_worldzone();
+  UnitTest( exists, true, "not decayed by the outdated entry" );
+  UnitTest( [&]() { return zone.decay_queue.size(); }, 1u, "newer entry kept" );
+
+  INFO_PRINTLN( "    recheck delay" );
+  item->movable( false );
+  Core::shift_clock_for_unittest( 60s );
+  Core::gameclock_t now = Core::read_gameclock();
+  d.decay_worldzone();
+  UnitTest( exists, true, "immovable not decayed" );
+  UnitTest( [&]() { return zone.decay_queue.due( now + Core::Decay::DECAY_RECHECK_DELAY ); },
+            false, "not due before the recheck delay" );
+  UnitTest( [&]() { return zone.decay_queue.due( now + Core::Decay::DECAY_RECHECK_DELAY + 1 ); },
+            true, "due after the recheck delay" );
+  item->movable( true );
+  Core::shift_clock_for_unittest(
+      std::chrono::seconds( Core::Decay::DECAY_RECHECK_DELAY + 2 ) );
+  d.decay_worldzone();
+  UnitTest( exists, false, "decayed at the recheck" );
+}
 }  // namespace Pol::Testing
@@ -83,6 +83,7 @@ void test_splitnamevalue();
 void test_convertquotedstring();
 void test_sanitizeUnicodeWithIso();
 void test_encodingconversions();
+void configfile_test();
 
 void map_test();
 void skilladv_test();
@@ -93,6 +94,10 @@ void los_test();
 void dynprops_test();
 void dummy();
 void packet_test();
+void latency_histogram_test();
+void cprop_test();
+void dictionary_test();
+void executor_modules_test();
 
 void vector2d_test();
 void vector3d_test();
@@ -105,6 +110,7 @@ void range3d_test();
 void test_curlfeatures();
 
 void decay_test();
+void decay_queue_test();
 }  // namespace Testing
 }  // namespace Pol
 #endif
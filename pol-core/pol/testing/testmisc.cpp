@@ -5,16 +5,40 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include "../../bscript/bobject.h"
+#include "../../bscript/dict.h"
+#include "../../bscript/impstr.h"
+#include "../../clib/cfgelem.h"
+#include "../../clib/cfgfile.h"
 #include "../../clib/logfacility.h"
 #include "../../clib/rawtypes.h"
+#include "../../clib/timer.h"
 #include "../../plib/maptile.h"
 #include "../dynproperties.h"
+#include "../globals/network.h"
+#include "../globals/settings.h"
 #include "../globals/uvars.h"
 #include "../network/packethelper.h"
+#include "../proplist.h"
+#include "../module/uomod.h"
+#include "../multi/customhouses.h"
 #include "../realms/realm.h"
+#include "../scrsched.h"
+#include "../uoexec.h"
 #include "testenv.h"
 
 #include <curl/curl.h>
@@ -372,5 +396,465 @@ void test_curlfeatures()
   else
     UnitTest::inc_successes();
 }
+
+void latency_histogram_test()
+{
+  using namespace std::chrono_literals;
+  Tools::LatencyHistogram hist;
+  UnitTest( [&]() { return hist.quantile( 0.5 ).count(); }, 0, "empty quantile" );
+  for ( int i = 0; i < 98; ++i )
+    hist.record( 15us );  // bucket 10-20us
+  hist.record( 3ms );     // bucket 2-5ms
+  hist.record( 1min );    // +Inf
+  UnitTest( [&]() { return hist.count(); }, 100u, "count" );
+  UnitTest( [&]() { return hist.quantile( 0.5 ).count(); }, 15, "p50" );
+  UnitTest( [&]() { return hist.quantile( 0.99 ).count(); }, 5000, "p99" );
+  UnitTest( [&]() { return hist.quantile( 1.0 ).count(); }, 10000000, "p100" );
+
+  std::string out;
+  hist.write_prometheus( out, "pol_test", "test" );
+  auto contains = [&]( const std::string& line ) { return out.find( line ) != std::string::npos; };
+  UnitTest( [&]() { return contains( "pol_test_seconds_bucket{le=\"2e-05\"} 98\n" ); }, true,
+            "prometheus bucket" );
+  UnitTest( [&]() { return contains( "pol_test_seconds_count 100\n" ); }, true,
+            "prometheus count" );
+  hist.reset();
+  UnitTest( [&]() { return hist.count(); }, 0u, "reset" );
+}
+
+void cprop_test()
+{
+  using namespace Bscript;
+  Core::PropertyList props( Core::CPropProfiler::Type::UNKNOWN );
+  auto get_rep = [&]( const std::string& name )
+  {
+    std::unique_ptr<BObjectImp> val( props.getpropimp( name ) );
+    return val ? val->getStringRep() : std::string( "<missing>" );
+  };
+
+  std::unique_ptr<ObjArray> arr( new ObjArray );
+  arr->addElement( new BLong( 1 ) );
+  arr->addElement( new String( "a b" ) );
+  props.setpropimp( "arr", *arr );
+  UnitTest(
+      [&]()
+      {
+        std::string packed;
+        props.getprop( "arr", packed );
+        return packed;
+      },
+      arr->pack(), "packed form of decoded value" );
+
+  // readers get their own copy
+  std::unique_ptr<BObjectImp> first( props.getpropimp( "arr" ) );
+  static_cast<ObjArray*>( first.get() )->addElement( new BLong( 2 ) );
+  UnitTest( [&]() { return get_rep( "arr" ); }, arr->getStringRep(), "copy on read" );
+  // as well as the writer
+  arr->addElement( new BLong( 3 ) );
+  UnitTest( [&]() { return get_rep( "arr" ); }, std::string( "{ 1, a b }" ), "copy on write" );
+
+  auto dict_imp = new BDictionary;
+  dict_imp->addMember( new String( "key" ), new Double( 0.5 ) );
+  std::unique_ptr<BObjectImp> dict( dict_imp );
+  props.setprop( "dict", dict->pack() );
+  UnitTest( [&]() { return get_rep( "dict" ); }, dict->getStringRep(), "decode packed value" );
+  UnitTest( [&]() { return get_rep( "missing" ); }, std::string( "<missing>" ), "missing" );
+
+  Core::PropertyList copied( props );
+  UnitTest( [&]() { return copied == props; }, true, "compare copy" );
+  props.setpropimp( "dict", *std::unique_ptr<BObjectImp>( new BLong( 1 ) ) );
+  UnitTest( [&]() { return copied == props; }, false, "compare after write" );
+}
+
+void dictionary_test()
+{
+  using namespace Bscript;
+  // the hashed contents have to behave like the sorted map they replaced
+  DictionaryContents contents;
+  std::map<BObject, BObjectRef> reference;
+  auto key_order = []( const auto& container )
+  {
+    std::string keys;
+    for ( const auto& entry : container )
+      keys += entry.first->getStringRep() + ",";
+    return keys;
+  };
+  auto make_key = []( int i ) -> BObjectImp*
+  {
+    switch ( i % 4 )
+    {
+    case 0:
+      return new BLong( i );
+    case 1:
+      return new String( fmt::format( "k{}", i ) );
+    case 2:
+      return new Double( i + 0.5 );
+    default:
+      return new Double( i );  // same key as BLong( i )
+    }
+  };
+  for ( int i = 0; i < 200; ++i )
+  {
+    BObject key( make_key( ( i * 7 ) % 101 ) );
+    contents[key] = BObjectRef( new BObject( new BLong( i ) ) );
+    reference[key] = BObjectRef( new BObject( new BLong( i ) ) );
+  }
+  UnitTest( [&]() { return contents.size(); }, reference.size(), "size" );
+  UnitTest( [&]() { return key_order( contents ); }, key_order( reference ), "sorted order" );
+  for ( int i = 0; i < 101; i += 3 )
+  {
+    BObject key( make_key( i ) );
+    contents.erase( key );
+    reference.erase( key );
+    BObject other( make_key( i + 200 ) );
+    contents[other] = BObjectRef( new BObject( new BLong( i ) ) );
+    reference[other] = BObjectRef( new BObject( new BLong( i ) ) );
+  }
+  UnitTest( [&]() { return key_order( contents ); }, key_order( reference ),
+            "sorted order after erase" );
+  UnitTest( [&]() { return contents.count( BObject( new Double( 4 ) ) ); }, size_t( 1 ),
+            "integral real finds integer key" );
+  UnitTest( [&]() { return contents.find( BObject( new String( "missing" ) ) ) == nullptr; },
+            true, "missing key" );
+
+  std::unique_ptr<BObjectImp> dict( new BDictionary );
+  static_cast<BDictionary*>( dict.get() )->addMember( new String( "b" ), new BLong( 1 ) );
+  static_cast<BDictionary*>( dict.get() )->addMember( new BLong( 2 ), new String( "x" ) );
+  static_cast<BDictionary*>( dict.get() )->addMember( new String( "a" ), new Double( 0.5 ) );
+  UnitTest( [&]() { return dict->pack(); }, std::string( "d3:S1:ar0.5S1:bi1i2S1:x" ), "pack" );
+  std::unique_ptr<BObjectImp> unpacked( BObjectImp::unpack( dict->pack().c_str() ) );
+  UnitTest( [&]() { return unpacked->pack(); }, dict->pack(), "unpack" );
+}
+
+void executor_modules_test()
+{
+  std::unique_ptr<Core::UOExecutor> ex( Core::create_script_executor() );
+  UnitTest( [&]() { return ex->findModule( "BASIC" ) != nullptr; }, true, "lazy module created" );
+  UnitTest( [&]() { return ex->findModule( "basic" ) == ex->findModule( "Basic" ); }, true,
+            "lazy module created once" );
+  UnitTest( [&]() { return ex->findModule( "nomodule" ) == nullptr; }, true, "unknown module" );
+}
+
+void configfile_test()
+{
+  const std::string filename = "configfile_test.tmp";
+  {
+    std::ofstream ofs( filename, std::ios::binary );
+    ofs << "\xEF\xBB\xBF# comment\r\n"
+        << "Menu main\r\n{\r\n"
+        << "\tSubMenu 1\r\n\tEntry 2\r\n\tname=Main\r\n\tEntry 3\r\n\tQuoted \"a\\\"b\"\r\n"
+        << "\tLong " << std::string( 3000, 'x' ) << "\r\n}\r\n\r\n"
+        << "Item\n{\n\tSerial 0x40000001\n}";
+  }
+  {
+    Clib::ConfigFile cf( filename, "MENU ITEM" );
+    Clib::ConfigElem elem;
+    UnitTest( [&]() { return cf.read( elem ); }, true, "read element" );
+    UnitTest( [&]() { return std::string( elem.rest() ); }, "main", "element rest" );
+    UnitTest( [&]() { return elem.remove_string( "NAME" ); }, "Main", "case insensitive name" );
+    UnitTest( [&]() { return elem.remove_string( "quoted" ); }, "a\"b", "quoted value" );
+    UnitTest( [&]() { return elem.remove_string( "Long" ).size(); }, 3000u, "long line" );
+    UnitTest(
+        [&]()
+        {
+          std::string order, name, value;
+          while ( elem.remove_first_prop( &name, &value ) )
+            order += name + value + " ";
+          return order;
+        },
+        "Entry2 Entry3 SubMenu1 ", "remove_first_prop by name, equal names in file order" );
+    UnitTest( [&]() { return cf.read( elem ) && elem.type_is( "item" ); }, true,
+              "element without trailing newline" );
+    UnitTest( [&]() { return elem.remove_ulong( "SERIAL" ); }, 0x40000001u, "serial" );
+    UnitTest( [&]() { return cf.read( elem ); }, false, "end of file" );
+  }
+  std::remove( filename.c_str() );
+}
+
+#ifdef ENABLE_BENCHMARK
+namespace
+{
+// 0 long, 1 string, 2 array of 10 longs, 3 dictionary of 10 string->long
+std::unique_ptr<Bscript::BObjectImp> cprop_benchmark_value( int kind )
+{
+  using namespace Bscript;
+  switch ( kind )
+  {
+  case 0:
+    return std::unique_ptr<BObjectImp>( new BLong( 123456 ) );
+  case 1:
+    return std::unique_ptr<BObjectImp>( new String( "some longer string value of a cprop" ) );
+  case 2:
+  {
+    auto arr = new ObjArray;
+    for ( int i = 0; i < 10; ++i )
+      arr->addElement( new BLong( i * 1000 ) );
+    return std::unique_ptr<BObjectImp>( arr );
+  }
+  default:
+  {
+    auto dict = new BDictionary;
+    for ( int i = 0; i < 10; ++i )
+      dict->addMember( new String( fmt::format( "key{}", i ) ), new BLong( i ) );
+    return std::unique_ptr<BObjectImp>( dict );
+  }
+  }
+}
+}  // namespace
+
+// the old way: every access packs or unpacks
+static void BM_cprop_get_packed( benchmark::State& state )
+{
+  Core::PropertyList props( Core::CPropProfiler::Type::UNKNOWN );
+  props.setprop( "prop", cprop_benchmark_value( state.range( 0 ) )->pack() );
+  std::string val;
+  while ( state.KeepRunning() )
+  {
+    props.getprop( "prop", val );
+    std::unique_ptr<Bscript::BObjectImp> imp( Bscript::BObjectImp::unpack( val.c_str() ) );
+    benchmark::DoNotOptimize( imp );
+  }
+}
+BENCHMARK( BM_cprop_get_packed )->DenseRange( 0, 3 );
+
+static void BM_cprop_get_decoded( benchmark::State& state )
+{
+  Core::PropertyList props( Core::CPropProfiler::Type::UNKNOWN );
+  props.setpropimp( "prop", *cprop_benchmark_value( state.range( 0 ) ) );
+  while ( state.KeepRunning() )
+  {
+    std::unique_ptr<Bscript::BObjectImp> imp( props.getpropimp( "prop" ) );
+    benchmark::DoNotOptimize( imp );
+  }
+}
+BENCHMARK( BM_cprop_get_decoded )->DenseRange( 0, 3 );
+
+static void BM_cprop_set_packed( benchmark::State& state )
+{
+  Core::PropertyList props( Core::CPropProfiler::Type::UNKNOWN );
+  auto value = cprop_benchmark_value( state.range( 0 ) );
+  while ( state.KeepRunning() )
+    props.setprop( "prop", value->pack() );
+}
+BENCHMARK( BM_cprop_set_packed )->DenseRange( 0, 3 );
+
+static void BM_cprop_set_decoded( benchmark::State& state )
+{
+  Core::PropertyList props( Core::CPropProfiler::Type::UNKNOWN );
+  auto value = cprop_benchmark_value( state.range( 0 ) );
+  while ( state.KeepRunning() )
+    props.setpropimp( "prop", *value );
+}
+BENCHMARK( BM_cprop_set_decoded )->DenseRange( 0, 3 );
+
+// 0 string keys, 1 integer keys
+static Bscript::BObjectImp* dict_benchmark_key( int kind, int i )
+{
+  if ( kind == 0 )
+    return new Bscript::String( fmt::format( "itemtemplate_{}", i ) );
+  return new Bscript::BLong( i * 17 );
+}
+
+// the former storage of dictionaries
+static void BM_dict_build_map( benchmark::State& state )
+{
+  while ( state.KeepRunning() )
+  {
+    std::map<Bscript::BObject, Bscript::BObjectRef> contents;
+    for ( int i = 0; i < 20000; ++i )
+      contents[Bscript::BObject( dict_benchmark_key( state.range( 0 ), i ) )] =
+          Bscript::BObjectRef( new Bscript::BObject( new Bscript::BLong( i ) ) );
+    benchmark::DoNotOptimize( contents );
+  }
+}
+BENCHMARK( BM_dict_build_map )->DenseRange( 0, 1 );
+
+static void BM_dict_build( benchmark::State& state )
+{
+  while ( state.KeepRunning() )
+  {
+    Bscript::DictionaryContents contents;
+    for ( int i = 0; i < 20000; ++i )
+      contents[Bscript::BObject( dict_benchmark_key( state.range( 0 ), i ) )] =
+          Bscript::BObjectRef( new Bscript::BObject( new Bscript::BLong( i ) ) );
+    benchmark::DoNotOptimize( contents );
+  }
+}
+BENCHMARK( BM_dict_build )->DenseRange( 0, 1 );
+
+static void BM_dict_lookup_map( benchmark::State& state )
+{
+  std::map<Bscript::BObject, Bscript::BObjectRef> contents;
+  std::vector<Bscript::BObject> keys;
+  for ( int i = 0; i < 20000; ++i )
+  {
+    keys.emplace_back( dict_benchmark_key( state.range( 0 ), i ) );
+    contents[keys.back()] = Bscript::BObjectRef( new Bscript::BObject( new Bscript::BLong( i ) ) );
+  }
+  size_t i = 0;
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( contents.find( keys[i] ) );
+    i = ( i + 7919 ) % keys.size();
+  }
+}
+BENCHMARK( BM_dict_lookup_map )->DenseRange( 0, 1 );
+
+static void BM_dict_lookup( benchmark::State& state )
+{
+  Bscript::DictionaryContents contents;
+  std::vector<Bscript::BObject> keys;
+  for ( int i = 0; i < 20000; ++i )
+  {
+    keys.emplace_back( dict_benchmark_key( state.range( 0 ), i ) );
+    contents[keys.back()] = Bscript::BObjectRef( new Bscript::BObject( new Bscript::BLong( i ) ) );
+  }
+  size_t i = 0;
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( contents.find( keys[i] ) );
+    i = ( i + 7919 ) % keys.size();
+  }
+}
+BENCHMARK( BM_dict_lookup )->DenseRange( 0, 1 );
+
+// startup of a short script using basic and uo functions,
+// 0 creates every common module up front (as before), 1 only the used ones
+static void BM_script_executor_create( benchmark::State& state )
+{
+  static const char* const common_modules[] = { "basic",   "basicio", "cliloc",     "math",
+                                                "util",    "cfgfile", "boat",       "datafile",
+                                                "polsys",  "vitals",  "attributes", "storage",
+                                                "guilds",  "unicode", "party",      "sql",
+                                                "file" };
+  while ( state.KeepRunning() )
+  {
+    std::unique_ptr<Core::UOExecutor> ex( Core::create_script_executor() );
+    ex->addModule( new Module::UOExecutorModule( *ex ) );
+    if ( state.range( 0 ) == 0 )
+    {
+      for ( const char* name : common_modules )
+        ex->findModule( name );
+    }
+    else
+      ex->findModule( "basic" );
+    benchmark::DoNotOptimize( ex->findModule( "uo" ) );
+  }
+}
+BENCHMARK( BM_script_executor_create )->DenseRange( 0, 1 );
+
+// parses an items.txt shaped file with the given number of items
+static void BM_configfile_read_items( benchmark::State& state )
+{
+  const std::string filename = "configfile_benchmark.tmp";
+  int64_t filesize = 0;
+  {
+    std::ofstream ofs( filename );
+    for ( int i = 0; i < state.range( 0 ); ++i )
+    {
+      ofs << fmt::format(
+          "Item\n{{\n\tName\tsome item {0}\n\tSerial\t{1:#x}\n\tObjType\t0xeed\n"
+          "\tGraphic\t0xeed\n\tX\t{2}\n\tY\t{3}\n\tZ\t0\n\tRealm\tbritannia\n"
+          "\tContainer\t{4:#x}\n\tCProp\tsomeprop sa longer string value\n"
+          "\tCProp\tother i{0}\n\tMovable\t1\n}}\n\n",
+          i, 0x40000000 + i, i % 6000, i % 4000, 0x40000000 + i / 10 );
+    }
+    filesize = ofs.tellp();
+  }
+  while ( state.KeepRunning() )
+  {
+    Clib::ConfigFile cf( filename, "ITEM" );
+    Clib::ConfigElem elem;
+    while ( cf.read( elem ) )
+    {
+      benchmark::DoNotOptimize( elem.remove_ulong( "SERIAL" ) );
+      std::string name, value;
+      while ( elem.remove_first_prop( &name, &value ) )
+        benchmark::DoNotOptimize( value );
+    }
+  }
+  state.SetBytesProcessed( state.iterations() * filesize );
+  std::remove( filename.c_str() );
+}
+BENCHMARK( BM_configfile_read_items )->Arg( 100000 )->Unit( benchmark::kMillisecond );
+
+// log calls per second into a flex log from several threads, includes messages dropped
+// while the log queue is full
+static void BM_log_flexlog( benchmark::State& state )
+{
+  // the threads start and stop the loop together, only the first one opens and removes the file
+  static std::string id;
+  if ( state.thread_index == 0 )
+    id = OPEN_FLEXLOG( "log_benchmark.tmp", false );
+  int i = 0;
+  while ( state.KeepRunning() )
+    FLEXLOGLN( id, "thread {} message {} with some text", state.thread_index, ++i );
+  state.SetItemsProcessed( state.iterations() );
+  if ( state.thread_index == 0 )
+  {
+    CLOSE_FLEXLOG( id );
+    Clib::Logging::global_logger->wait_for_empty_queue();
+    std::remove( "log_benchmark.tmp" );
+  }
+}
+BENCHMARK( BM_log_flexlog )->Threads( 1 )->Threads( 4 )->UseRealTime();
+
+// single tile edit on a fully built 30x30 custom house followed by compressing the design for the
+// 0xD8 packet, as done for every design change of the house tool
+static void BM_customhouse_edit_compress( benchmark::State& state )
+{
+  const int size = 30;
+  Multi::CustomHouseDesign design( size + 1, size, size / 2, size / 2 );
+  for ( int floor = 0; floor < CUSTOM_HOUSE_NUM_PLANES; ++floor )
+  {
+    for ( int x = 0; x < size; ++x )
+    {
+      for ( int y = 0; y < size; ++y )
+      {
+        Multi::CUSTOM_HOUSE_ELEMENT elem;
+        elem.graphic = static_cast<u16>( 0x519 + ( x + y ) % 8 );
+        elem.xoffset = x - size / 2;
+        elem.yoffset = y - size / 2;
+        elem.z = Multi::CustomHouseDesign::custom_house_z_xlate_table[floor];
+        design.Add( elem );
+      }
+    }
+  }
+  Multi::CUSTOM_HOUSE_ELEMENT edit;
+  edit.graphic = 0x31F4;
+  edit.xoffset = 0;
+  edit.yoffset = 0;
+  edit.z = Multi::CustomHouseDesign::custom_house_z_xlate_table[2];
+  while ( state.KeepRunning() )
+  {
+    design.Add( edit );
+    design.EraseGraphicAt( edit.graphic, edit.xoffset, edit.yoffset, edit.z );
+    for ( int floor = 0; floor < design.NumUsedPlanes(); ++floor )
+    {
+      u32 ulen;
+      benchmark::DoNotOptimize( design.CompressedPlane( floor, &ulen ) );
+    }
+  }
+}
+BENCHMARK( BM_customhouse_edit_compress )->Unit( benchmark::kMicrosecond );
+
+// compression of a typical gump layout, arg 0 disables the gump cache
+static void BM_gump_layout_compress( benchmark::State& state )
+{
+  std::string layout;
+  layout += "{ page 0 }{ resizepic 0 0 9200 400 500 }{ gumppic 20 20 100 }";
+  for ( int i = 0; i < 40; ++i )
+    layout += fmt::format( "{{ button 30 {0} 4005 4007 1 0 {1} }}{{ text 70 {0} 0 {1} }}",
+                           60 + i * 10, i );
+  const auto cache_size = Core::settingsManager.ssopt.gump_cache_size;
+  Core::settingsManager.ssopt.gump_cache_size = static_cast<unsigned int>( state.range( 0 ) );
+  while ( state.KeepRunning() )
+    benchmark::DoNotOptimize(
+        Core::networkManager.gump_cache.compress( layout.c_str(), layout.size() + 1 ) );
+  Core::networkManager.gump_cache.clear();
+  Core::settingsManager.ssopt.gump_cache_size = cache_size;
+}
+BENCHMARK( BM_gump_layout_compress )->Arg( 0 )->Arg( 1000 );
+#endif
 }  // namespace Testing
 }  // namespace Pol
@@ -14,16 +14,22 @@
 
 #include <stddef.h>
 #include <string>
+#include <unordered_set>
 
 #include "../bscript/impstr.h"
 #include "../clib/clib_endian.h"
 #include "../clib/rawtypes.h"
+#include "fnsearch.h"
+#include "globals/network.h"
+#include "globals/settings.h"
 #include "item/item.h"
 #include "item/itemdesc.h"
 #include "mobile/charactr.h"
 #include "network/client.h"
+#include "network/clienttransmit.h"
 #include "network/packetdefs.h"
 #include "network/packethelper.h"
+#include "network/packethooks.h"
 #include "network/packets.h"
 #include "network/pktin.h"
 #include "ufunc.h"
@@ -90,7 +96,9 @@ void send_object_cache_to_inrange( const UObject* obj )
 }
 
 
-void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content )
+namespace
+{
+std::string tooltip_description( UObject* obj, bool vendor_content )
 {
   std::string desc;
   if ( obj->isa( UOBJ_CLASS::CLASS_CHARACTER ) )
@@ -110,8 +118,11 @@ void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content
   }
   else
     desc = obj->description();
+  return desc;
+}
 
-  PacketOut<Network::PktOut_D6> msg;
+void build_aos_tooltip( PacketOut<Network::PktOut_D6>& msg, UObject* obj, bool vendor_content )
+{
   msg->offset += 2;
   msg->WriteFlipped<u16>( 1u );  // u16 unk1
   msg->Write<u32>( obj->serial_ext );
@@ -122,7 +133,7 @@ void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content
   else
     msg->WriteFlipped<u32>( 1042971u );  // 1 text argument only
 
-  std::vector<u16> utf16 = Bscript::String::toUTF16( desc );
+  std::vector<u16> utf16 = Bscript::String::toUTF16( tooltip_description( obj, vendor_content ) );
   u16 textlen = static_cast<u16>( utf16.size() );
   if ( ( textlen * 2 ) > ( 0xFFFF - 22 ) )
   {
@@ -135,7 +146,167 @@ void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content
   u16 len = msg->offset;
   msg->offset = 1;
   msg->WriteFlipped<u16>( len );
-  msg.Send( client, len );
+  msg->offset = len;
+}
+
+// returns the cached packet of given object, builds and caches it if needed
+// merchant descriptions depend on the price which does not change the revision, these are never
+// cached
+const std::vector<u8>* cached_aos_tooltip( UObject* obj )
+{
+  auto& cache = networkManager.tooltip_cache;
+  if ( const auto* pkt = cache.find( obj->serial, obj->rev() ) )
+    return pkt;
+  if ( !settingsManager.ssopt.tooltip_cache_size )
+    return nullptr;
+  PacketOut<Network::PktOut_D6> msg;
+  build_aos_tooltip( msg, obj, false );
+  const u8* data = reinterpret_cast<const u8*>( &msg->buffer );
+  cache.insert( obj->serial, obj->rev(), std::vector<u8>( data, data + msg->offset ) );
+  return cache.find( obj->serial, obj->rev() );
+}
+}  // namespace
+
+void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content )
+{
+  if ( !vendor_content )
+  {
+    if ( const auto* pkt = cached_aos_tooltip( obj ) )
+    {
+      networkManager.clientTransmit->AddToQueue( client, pkt->data(),
+                                                 static_cast<int>( pkt->size() ) );
+      return;
+    }
+  }
+  PacketOut<Network::PktOut_D6> msg;
+  build_aos_tooltip( msg, obj, vendor_content );
+  msg.Send( client );
+}
+
+/// Answers the multi serial form of 0xD6.
+/// The packets are collected into one buffer to be queued at once, as long as no script hooks the
+/// outgoing packet.
+void SendAOSTooltips( Network::Client* client, const std::vector<u32>& serials )
+{
+  std::vector<u8> buffer;
+  bool hooked = false;
+  auto flush = [&]()
+  {
+    if ( !buffer.empty() )
+      networkManager.clientTransmit->AddToQueue( client, buffer.data(),
+                                                 static_cast<int>( buffer.size() ) );
+    buffer.clear();
+  };
+  // clients tend to request the same serial multiple times
+  std::unordered_set<u32> seen;
+  seen.reserve( serials.size() );
+  for ( u32 serial : serials )
+  {
+    if ( !seen.insert( serial ).second )
+      continue;
+    UObject* obj = system_find_object( serial );
+    if ( obj == nullptr )
+      continue;
+    const auto* pkt = cached_aos_tooltip( obj );
+    if ( pkt == nullptr || hooked )
+    {
+      SendAOSTooltip( client, obj );
+      continue;
+    }
+    if ( buffer.empty() )
+    {
+      const void* data = pkt->data();
+      Network::PacketHookData* phd = nullptr;
+      if ( Network::GetAndCheckPacketHooked( client, data, phd ) )
+      {
+        hooked = true;
+        SendAOSTooltip( client, obj );
+        continue;
+      }
+    }
+    // Client::xmit takes at most 0xFFFF bytes at once
+    if ( buffer.size() + pkt->size() > 0xFFFF )
+      flush();
+    buffer.insert( buffer.end(), pkt->begin(), pkt->end() );
+  }
+  flush();
+}
+
+TooltipCache::TooltipCache() : _entries(), _index(), _hits( 0 ), _misses( 0 ) {}
+
+const std::vector<u8>* TooltipCache::find( u32 serial, u32 rev )
+{
+  auto itr = _index.find( serial );
+  if ( itr == _index.end() )
+  {
+    ++_misses;
+    return nullptr;
+  }
+  if ( itr->second->rev != rev )
+  {
+    ++_misses;
+    _entries.erase( itr->second );
+    _index.erase( itr );
+    return nullptr;
+  }
+  ++_hits;
+  _entries.splice( _entries.begin(), _entries, itr->second );
+  return &itr->second->pkt;
+}
+
+void TooltipCache::insert( u32 serial, u32 rev, std::vector<u8>&& pkt )
+{
+  const size_t max_size = settingsManager.ssopt.tooltip_cache_size;
+  if ( !max_size )
+    return;
+  invalidate( serial );
+  while ( _entries.size() >= max_size )
+  {
+    _index.erase( _entries.back().serial );
+    _entries.pop_back();
+  }
+  _entries.push_front( Entry{ serial, rev, std::move( pkt ) } );
+  _index.emplace( serial, _entries.begin() );
+}
+
+void TooltipCache::invalidate( u32 serial )
+{
+  auto itr = _index.find( serial );
+  if ( itr == _index.end() )
+    return;
+  _entries.erase( itr->second );
+  _index.erase( itr );
+}
+
+void TooltipCache::clear()
+{
+  _index.clear();
+  _entries.clear();
+}
+
+size_t TooltipCache::size() const
+{
+  return _entries.size();
+}
+
+size_t TooltipCache::estimateSize() const
+{
+  size_t size = sizeof( TooltipCache );
+  for ( const auto& entry : _entries )
+    size += sizeof( Entry ) + 2 * sizeof( void* ) + entry.pkt.capacity();
+  size += _index.size() * ( sizeof( u32 ) + sizeof( EntryList::iterator ) + sizeof( void* ) ) +
+          _index.bucket_count() * sizeof( void* );
+  return size;
+}
+
+u64 TooltipCache::hits() const
+{
+  return _hits;
+}
+
+u64 TooltipCache::misses() const
+{
+  return _misses;
 }
 }  // namespace Core
 }  // namespace Pol
@@ -9,6 +9,13 @@
 #ifndef __TOOLTIPS_H
 #define __TOOLTIPS_H
 
+#include <list>
+#include <stddef.h>
+#include <unordered_map>
+#include <vector>
+
+#include "../clib/rawtypes.h"
+
 namespace Pol
 {
 namespace Network
@@ -21,6 +28,47 @@ class UObject;
 void send_object_cache( Network::Client* client, const UObject* obj );
 void send_object_cache_to_inrange( const UObject* obj );
 void SendAOSTooltip( Network::Client* client, UObject* item, bool vendor_content = false );
-}
-}
+void SendAOSTooltips( Network::Client* client, const std::vector<u32>& serials );
+
+/**
+ * LRU cache of ready-to-send 0xD6 tooltip packets.
+ *
+ * An entry is only valid as long as the object revision matches, every change which influences
+ * the tooltip text increases the revision (see UObject::increv).
+ * The maximum number of entries is defined by ServSpecOpt TooltipCacheSize, 0 disables the cache.
+ */
+class TooltipCache
+{
+public:
+  TooltipCache();
+  TooltipCache( const TooltipCache& ) = delete;
+  TooltipCache& operator=( const TooltipCache& ) = delete;
+
+  const std::vector<u8>* find( u32 serial, u32 rev );
+  void insert( u32 serial, u32 rev, std::vector<u8>&& pkt );
+  void invalidate( u32 serial );
+  void clear();
+
+  size_t size() const;
+  size_t estimateSize() const;
+  u64 hits() const;
+  u64 misses() const;
+
+private:
+  struct Entry
+  {
+    u32 serial;
+    u32 rev;
+    std::vector<u8> pkt;
+  };
+  typedef std::list<Entry> EntryList;
+
+  // most recently used entry is at the front
+  EntryList _entries;
+  std::unordered_map<u32, EntryList::iterator> _index;
+  u64 _hits;
+  u64 _misses;
+};
+}  // namespace Core
+}  // namespace Pol
 #endif
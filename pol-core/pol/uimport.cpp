@@ -15,16 +15,28 @@
 
 #include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <exception>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <time.h>
+#include <vector>
+#ifndef _WIN32
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "../clib/Program/ProgramConfig.h"
 #include "../clib/cfgelem.h"
 #include "../clib/cfgfile.h"
+#include "../clib/cfgprefetch.h"
 #include "../clib/clib.h"
 #include "../clib/clib_endian.h"
 #include "../clib/esignal.h"
@@ -68,7 +80,9 @@ namespace Pol
 {
 namespace Module
 {
+void advance_datastore_versions();
 void commit_datastore();
+void finish_forked_datastore_save( bool success );
 void read_datastore_dat();
 void write_datastore( Clib::StreamWriter& sw );
 }  // namespace Module
@@ -85,6 +99,12 @@ void read_guilds_dat();
 void write_guilds( Clib::StreamWriter& sw );
 
 std::shared_future<bool> SaveContext::finished;
+// set while the datastore of a forked save waits for its result
+static bool forked_datastore_pending = false;
+// the last forked save failed, the next save is done without fork
+static bool forked_save_failed = false;
+// deleted serials not yet written by an incremental save when the pending forked save started
+static std::vector<u32> forked_deleted_serials;
 
 /****************** POL Native Files *******************/
 // Dave changed 3/8/3 to use objecthash
@@ -369,63 +389,109 @@ std::string elapsed( clock_t start, clock_t end )
   return Clib::tostring( ms ) + " ms";
 }
 
-void slurp( const char* filename, const char* tags, int sysfind_flags )
+namespace
+{
+void slurp( Clib::ConfigFilePrefetcher& reader, int sysfind_flags )
 {
   static int num_until_dot = 1000;
 
-  if ( Clib::FileExists( filename ) )
-  {
-    INFO_PRINT( "  {}:", filename );
-    Clib::ConfigFile cf( filename, tags );
-    Clib::ConfigElem elem;
+  INFO_PRINT( "  {}:", reader.filename() );
 
-    Tools::Timer<> timer;
+  Tools::Timer<> timer;
 
-    unsigned int nobjects = 0;
-    while ( cf.read( elem ) )
+  unsigned int nobjects = 0;
+  while ( Clib::ConfigElem* next = reader.next() )
+  {
+    Clib::ConfigElem& elem = *next;
+    if ( --num_until_dot == 0 )
     {
-      if ( --num_until_dot == 0 )
-      {
-        INFO_PRINT( "." );
-        num_until_dot = 1000;
-      }
-      try
+      INFO_PRINT( "." );
+      num_until_dot = 1000;
+    }
+    try
+    {
+      if ( stricmp( elem.type(), "CHARACTER" ) == 0 )
+        read_character( elem );
+      else if ( stricmp( elem.type(), "NPC" ) == 0 )
+        read_npc( elem );
+      else if ( stricmp( elem.type(), "ITEM" ) == 0 )
+        read_global_item( elem, sysfind_flags );
+      else if ( stricmp( elem.type(), "GLOBALPROPERTIES" ) == 0 )
+        gamestate.global_properties->readProperties( elem );
+      else if ( elem.type_is( "SYSTEM" ) )
+        read_system_vars( elem );
+      else if ( elem.type_is( "MULTI" ) )
+        read_multi( elem );
+      else if ( elem.type_is( "STORAGEAREA" ) )
       {
-        if ( stricmp( elem.type(), "CHARACTER" ) == 0 )
-          read_character( elem );
-        else if ( stricmp( elem.type(), "NPC" ) == 0 )
-          read_npc( elem );
-        else if ( stricmp( elem.type(), "ITEM" ) == 0 )
-          read_global_item( elem, sysfind_flags );
-        else if ( stricmp( elem.type(), "GLOBALPROPERTIES" ) == 0 )
-          gamestate.global_properties->readProperties( elem );
-        else if ( elem.type_is( "SYSTEM" ) )
-          read_system_vars( elem );
-        else if ( elem.type_is( "MULTI" ) )
-          read_multi( elem );
-        else if ( elem.type_is( "STORAGEAREA" ) )
-        {
-          StorageArea* storage_area = gamestate.storage.create_area( elem );
-          // this will be followed by an item
-          if ( !cf.read( elem ) )
-            throw std::runtime_error( "Expected an item to exist after the storagearea." );
+        StorageArea* storage_area = gamestate.storage.create_area( elem );
+        // this will be followed by an item
+        Clib::ConfigElem* item_elem = reader.next();
+        if ( !item_elem )
+          throw std::runtime_error( "Expected an item to exist after the storagearea." );
 
-          storage_area->load_item( elem );
-        }
-        else if ( elem.type_is( "REALM" ) )
-          read_shadow_realms( elem );
-      }
-      catch ( std::exception& )
-      {
-        if ( !Plib::systemstate.config.ignore_load_errors )
-          throw;
+        storage_area->load_item( *item_elem );
       }
-      ++nobjects;
+      else if ( elem.type_is( "REALM" ) )
+        read_shadow_realms( elem );
     }
+    catch ( std::exception& )
+    {
+      if ( !Plib::systemstate.config.ignore_load_errors )
+        throw;
+    }
+    ++nobjects;
+  }
 
-    timer.stop();
+  timer.stop();
 
-    INFO_PRINTLN( " {} elements in {} ms.", nobjects, timer.ellapsed() );
+  INFO_PRINTLN( " {} elements in {} ms (parsed in {} ms, {} ms waiting for the parser).", nobjects,
+                timer.ellapsed(),
+                std::chrono::duration_cast<std::chrono::milliseconds>( reader.parse_time() ).count(),
+                std::chrono::duration_cast<std::chrono::milliseconds>( reader.wait_time() ).count() );
+}
+
+struct WorldDatafile
+{
+  const char* basename;
+  const char* tags;
+  int sysfind_flags;
+};
+
+// in load order, contained items are inserted into their containers after all files are read
+const WorldDatafile world_datafiles[] = {
+    { "objects", "CHARACTER NPC ITEM GLOBALPROPERTIES", 0 },
+    { "pcs", "CHARACTER ITEM", SYSFIND_SKIP_WORLD },
+    { "pcequip", "ITEM", SYSFIND_SKIP_WORLD },
+    { "npcs", "NPC ITEM", SYSFIND_SKIP_WORLD },
+    { "npcequip", "ITEM", SYSFIND_SKIP_WORLD },
+    { "items", "ITEM", 0 },
+    { "multis", "MULTI", 0 },
+};
+
+// starts parsing all world datafiles at once, the objects are created later in load order
+std::vector<std::unique_ptr<Clib::ConfigFilePrefetcher>> open_world_datafiles()
+{
+  std::vector<std::unique_ptr<Clib::ConfigFilePrefetcher>> readers;
+  for ( const auto& datafile : world_datafiles )
+  {
+    std::string filename =
+        Plib::systemstate.config.world_data_path + datafile.basename + ".txt";
+    if ( Clib::FileExists( filename ) )
+      readers.push_back( std::make_unique<Clib::ConfigFilePrefetcher>( filename, datafile.tags ) );
+    else
+      readers.emplace_back();
+  }
+  return readers;
+}
+}  // namespace
+
+void slurp( const char* filename, const char* tags, int sysfind_flags )
+{
+  if ( Clib::FileExists( filename ) )
+  {
+    Clib::ConfigFilePrefetcher reader( filename, tags );
+    slurp( reader, sysfind_flags );
   }
 }
 
@@ -452,60 +518,6 @@ void read_pol_dat()
   }
 }
 
-void read_objects_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "objects.txt" ).c_str(),
-         "CHARACTER NPC ITEM GLOBALPROPERTIES" );
-}
-
-void read_pcs_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "pcs.txt" ).c_str(), "CHARACTER ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_pcequip_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "pcequip.txt" ).c_str(), "ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_npcs_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "npcs.txt" ).c_str(), "NPC ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_npcequip_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "npcequip.txt" ).c_str(), "ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_items_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "items.txt" ).c_str(), "ITEM" );
-}
-
-void read_multis_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "multis.txt" ).c_str(), "MULTI" );
-  //  string multisfile = config.world_data_path + "multis.txt";
-  //  if (FileExists( multisfile ))
-  //  {
-  //    cout << multisfile << ":";
-  //    ConfigFile cf( multisfile, "MULTI" );
-  //    ConfigElem elem;
-  //    while( cf.read( elem ))
-  //    {
-  //      UMulti* multi = read_multi( elem );
-  //      if (multi == nullptr) throw runtime_error( "multi creation returned nullptr!" );
-  //
-  //      add_multi_to_world( multi );
-  //    }
-  //  }
-}
-
 void read_storage_dat()
 {
   std::string storagefile = Plib::systemstate.config.world_data_path + "storage.txt";
@@ -646,20 +658,25 @@ int read_data()
 
   rename_dat_files();
 
+  // sets incremental_save_count, read_guilds_dat() and read_incremental_saves() rely on it
   load_incremental_indexes();
 
+  Tools::Timer<> read_timer;
+  auto world_readers = open_world_datafiles();
+
   read_pol_dat();
 
   // POL clock should be paused at this point.
   start_gameclock();
 
-  read_objects_dat();
-  read_pcs_dat();
-  read_pcequip_dat();
-  read_npcs_dat();
-  read_npcequip_dat();
-  read_items_dat();
-  read_multis_dat();
+  for ( size_t i = 0; i < world_readers.size(); ++i )
+  {
+    if ( world_readers[i] )
+    {
+      slurp( *world_readers[i], world_datafiles[i].sysfind_flags );
+      world_readers[i].reset();
+    }
+  }
   read_storage_dat();
   read_resources_dat();
   read_guilds_dat();
@@ -667,6 +684,9 @@ int read_data()
   read_party_dat();
 
   read_incremental_saves();
+  read_timer.stop();
+
+  Tools::Timer<> link_timer;
   insert_deferred_items();
 
   register_deleted_serials();
@@ -697,6 +717,10 @@ int read_data()
         chr->logged_in( false );
     }
   }
+  link_timer.stop();
+
+  INFO_PRINTLN( "World data read in {} ms, containers linked in {} ms.", read_timer.ellapsed(),
+                link_timer.ellapsed() );
 
   stateManager.gflag_in_system_load = false;
   return 0;
@@ -827,14 +851,48 @@ SaveContext::~SaveContext()
   party.flush_file();
 }
 
-/// blocks till possible last commit finishes
-void SaveContext::ready()
+// applies the result of the finished forked save
+static bool finish_forked_save()
+{
+  forked_datastore_pending = false;
+  bool result = SaveContext::finished.get();
+  Module::finish_forked_datastore_save( result );
+  if ( !result )
+  {
+    POLLOG_ERRORLN( "Forked worldsave failed, the next worldsave is done without fork." );
+    forked_save_failed = true;
+    // the dirty flags got cleared at the fork, everything has to go into the next save
+    for ( const auto& objitr : objStorageManager.objecthash )
+    {
+      if ( !objitr.second->orphan() )
+        objitr.second->set_dirty();
+    }
+    for ( u32 serial : forked_deleted_serials )
+      objStorageManager.objecthash.RegisterDirtyDeletedSerial( serial );
+  }
+  forked_deleted_serials.clear();
+  return result;
+}
+
+/// blocks till possible last commit finishes, false if it was a failed forked save
+bool SaveContext::ready()
 {
   if ( SaveContext::finished.valid() )
   {
     // Tools::Timer<Tools::DebugT> t("future");
     SaveContext::finished.wait();
+    if ( forked_datastore_pending )
+      return finish_forked_save();
   }
+  return true;
+}
+
+/// applies the result of a finished forked save, without waiting for a pending one
+void SaveContext::collect_finished()
+{
+  if ( forked_datastore_pending && SaveContext::finished.valid() &&
+       SaveContext::finished.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
+    finish_forked_save();
 }
 
 
@@ -1041,223 +1099,340 @@ bool should_write_data()
   return true;
 }
 
-int write_data( unsigned int& dirty_writes, unsigned int& clean_writes, long long& elapsed_ms )
+namespace
 {
-  SaveContext::ready();  // allow only one active
-  if ( !should_write_data() )
+// the parts of a full save, each of them writes its own datafiles
+struct SavePart
+{
+  const char* name;
+  void ( *write )( SaveContext& );
+};
+const SavePart save_parts[] = {
+    { "pol",
+      []( SaveContext& sc )
+      {
+        sc.pol.comment( "" );
+        sc.pol.comment( " Created by Version: {}", POL_VERSION_ID );
+        sc.pol.comment( " Mobiles: {}", get_mobile_count() );
+        sc.pol.comment( " Top-level Items: {}", get_toplevel_item_count() );
+        sc.pol.comment( "\n" );
+
+        write_system_data( sc.pol );
+        write_global_properties( sc.pol );
+        write_shadow_realms( sc.pol );
+      } },
+    { "items", []( SaveContext& sc ) { write_items( sc.items ); } },
+    { "character", []( SaveContext& sc ) { write_characters( sc ); } },
+    { "npcs", []( SaveContext& sc ) { write_npcs( sc ); } },
+    { "multis", []( SaveContext& sc ) { write_multis( sc.multis ); } },
+    { "storage", []( SaveContext& sc ) { gamestate.storage.print( sc.storage ); } },
+    { "resource", []( SaveContext& sc ) { write_resources_dat( sc.resource ); } },
+    { "guilds", []( SaveContext& sc ) { write_guilds( sc.guilds ); } },
+    { "datastore",
+      []( SaveContext& sc )
+      {
+        Module::write_datastore( sc.datastore );
+        // Atomically (hopefully) perform the switch.
+        Module::commit_datastore();
+      } },
+    { "party", []( SaveContext& sc ) { write_party( sc.party ); } },
+};
+
+bool write_save_part( const SavePart& part, SaveContext& sc )
+{
+  try
   {
-    dirty_writes = clean_writes = 0;
-    elapsed_ms = 0;
-    return -1;
+    part.write( sc );
+    return true;
+  }
+  catch ( ... )
+  {
+    POLLOG_ERRORLN( "failed to store {} datafile!", part.name );
+    Clib::force_backtrace();
+    return false;
   }
+}
 
-  UObject::dirty_writes = 0;
-  UObject::clean_writes = 0;
+void commit_save()
+{
+  commit( "pol" );
+  commit( "objects" );
+  commit( "pcs" );
+  commit( "pcequip" );
+  commit( "npcs" );
+  commit( "npcequip" );
+  commit( "items" );
+  commit( "multis" );
+  commit( "storage" );
+  commit( "resource" );
+  commit( "guilds" );
+  commit( "datastore" );
+  commit( "parties" );
+}
 
-  Tools::Timer<> timer;
-  // launch complete save as seperate thread
-  // but wait till the first critical part is finished
-  // which means all objects got written into a format object
-  // the remaining operations are only pure buffered i/o
-  auto critical_promise = std::make_shared<std::promise<bool>>();
-  auto critical_future = critical_promise->get_future();
-  SaveContext::finished = std::async(
-      std::launch::async,
-      [&, critical_promise]() -> bool
+void log_save_times( Tools::HighPerfTimer::Clock::time_point save_start, long long blocked_ms )
+{
+  auto total = Tools::HighPerfTimer::Clock::now() - save_start;
+  stateManager.tick_histograms.worldsave_total.record(
+      std::chrono::duration_cast<Tools::LatencyHistogram::time_mu>( total ) );
+  POLLOG_INFOLN( "Worldsave written in {} ms, the game was blocked for {} ms.",
+                 std::chrono::duration_cast<std::chrono::milliseconds>( total ).count(),
+                 blocked_ms );
+}
+
+#ifndef _WIN32
+// reads what is available from the stderr pipe of the child, false if the pipe got closed
+bool read_forked_output( int fd, std::string& output, int timeout_ms )
+{
+  pollfd pfd{ fd, POLLIN, 0 };
+  int res = poll( &pfd, 1, timeout_ms );
+  if ( res <= 0 )
+    return res == 0 || errno == EINTR;
+  char buf[4096];
+  ssize_t len = read( fd, buf, sizeof buf );
+  if ( len > 0 )
+  {
+    output.append( buf, static_cast<size_t>( len ) );
+    return true;
+  }
+  return len < 0 && errno == EINTR;
+}
+
+// waits for the child till the configured timeout, afterwards it gets killed
+// the errors reported by the child through its stderr pipe are logged here
+bool wait_for_forked_save( pid_t pid, int errfd, unsigned replaced_incremental_saves,
+                           Tools::HighPerfTimer::Clock::time_point save_start, long long blocked_ms )
+{
+  const auto timeout = std::chrono::seconds( Plib::systemstate.config.fork_worldsave_timeout );
+  std::string output;
+  bool pipe_open = true;
+  bool timed_out = false;
+  int status = 0;
+  pid_t res;
+  while ( ( res = waitpid( pid, &status, WNOHANG ) ) == 0 || ( res < 0 && errno == EINTR ) )
+  {
+    if ( Tools::HighPerfTimer::Clock::now() - save_start >= timeout )
+    {
+      timed_out = true;
+      kill( pid, SIGKILL );
+      while ( ( res = waitpid( pid, &status, 0 ) ) < 0 && errno == EINTR )
+        ;
+      break;
+    }
+    if ( pipe_open )
+      pipe_open = read_forked_output( errfd, output, 100 );
+    else
+      std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+  }
+  // the child is gone, read what is left in the pipe
+  while ( pipe_open )
+  {
+    size_t len = output.size();
+    pipe_open = read_forked_output( errfd, output, 0 );
+    if ( output.size() == len )
+      break;
+  }
+  close( errfd );
+
+  size_t pos = 0;
+  while ( pos < output.size() )
+  {
+    size_t end = output.find( '\n', pos );
+    if ( end == std::string::npos )
+      end = output.size();
+    if ( end > pos )
+      POLLOG_ERRORLN( "forked worldsave: {}", output.substr( pos, end - pos ) );
+    pos = end + 1;
+  }
+
+  bool result = !timed_out && res == pid && WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+  if ( result )
+  {
+    commit_save();
+    // the incremental saves made since the fork follow the new full save
+    std::lock_guard<std::mutex> lock( objStorageManager.incremental_save_mutex );
+    commit_incremental_saves( replaced_incremental_saves );
+    objStorageManager.incremental_save_count -= replaced_incremental_saves;
+  }
+  else if ( timed_out )
+    POLLOG_ERRORLN( "Forked worldsave did not finish within {} seconds and got killed.",
+                    timeout.count() );
+  else
+    POLLOG_ERRORLN( "failed to save datafiles!" );
+  log_save_times( save_start, blocked_ms );
+  return result;
+}
+
+/**
+ * Writes the world from a forked child process, the copy-on-write memory of the child is a
+ * consistent snapshot while the game continues. Only the fork itself blocks the game.
+ *
+ * @return false if the process could not be forked
+ */
+bool launch_forked_save( Tools::HighPerfTimer::Clock::time_point save_start )
+{
+  // the child has to get along without the logging thread
+  Clib::Logging::global_logger->wait_for_empty_queue();
+  int errpipe[2];
+  if ( pipe( errpipe ) != 0 )
+  {
+    POLLOG_ERRORLN( "Unable to create the pipe of the forked worldsave: {}",
+                    std::strerror( errno ) );
+    return false;
+  }
+  pid_t pid = fork();
+  if ( pid < 0 )
+  {
+    POLLOG_ERRORLN( "Unable to fork the worldsave: {}", std::strerror( errno ) );
+    close( errpipe[0] );
+    close( errpipe[1] );
+    return false;
+  }
+  if ( pid == 0 )
+  {
+    // only this thread exists in the child, the parts are written one after another and the
+    // process leaves without running any destructor or exit handler of the server
+    // errors go through stderr into the pipe, the parent logs them
+    close( errpipe[0] );
+    dup2( errpipe[1], STDERR_FILENO );
+    close( errpipe[1] );
+    Clib::Logging::global_logger->writeToStderr();
+    bool result = true;
+    try
+    {
+      SaveContext sc;
+      for ( const auto& part : save_parts )
       {
-        std::atomic<bool> result( true );
         try
         {
-          SaveContext sc;
-          std::vector<std::future<bool>> critical_parts;
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  sc.pol.comment( "" );
-                  sc.pol.comment( " Created by Version: {}", POL_VERSION_ID );
-                  sc.pol.comment( " Mobiles: {}", get_mobile_count() );
-                  sc.pol.comment( " Top-level Items: {}", get_toplevel_item_count() );
-                  sc.pol.comment( "\n" );
-
-                  write_system_data( sc.pol );
-                  write_global_properties( sc.pol );
-                  write_shadow_realms( sc.pol );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store pol datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_items( sc.items );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store items datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_characters( sc );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store character datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_npcs( sc );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store npcs datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_multis( sc.multis );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store multis datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  gamestate.storage.print( sc.storage );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store storage datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_resources_dat( sc.resource );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store resource datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_guilds( sc.guilds );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store guilds datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  Module::write_datastore( sc.datastore );
-                  // Atomically (hopefully) perform the switch.
-                  Module::commit_datastore();
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store datastore datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_party( sc.party );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERRORLN( "failed to store party datafile!" );
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          for ( auto& task : critical_parts )
-            task.wait();
-
-          critical_promise->set_value( result );  // critical part end
-          // TODO: since promise can only be set one time move it into a method with a dedicated try
-          // block, now when in theory an upper part fails the promise gets never set
-        }  // deconstructor of the SaveContext flushes and joins the queues
-        catch ( std::ios_base::failure& e )
+          part.write( sc );
+        }
+        catch ( std::exception& ex )
         {
-          POLLOG_ERRORLN( "failed to save datafiles! {}:{}", e.what(), std::strerror( errno ) );
-          Clib::force_backtrace();
+          fmt::print( stderr, "failed to store {} datafile! {}\n", part.name, ex.what() );
           result = false;
         }
         catch ( ... )
         {
-          POLLOG_ERRORLN( "failed to save datafiles!" );
-          Clib::force_backtrace();
+          fmt::print( stderr, "failed to store {} datafile!\n", part.name );
           result = false;
         }
-        if ( result )
+      }
+    }
+    catch ( std::exception& ex )
+    {
+      fmt::print( stderr, "failed to save datafiles! {}\n", ex.what() );
+      result = false;
+    }
+    catch ( ... )
+    {
+      fmt::print( stderr, "failed to save datafiles!\n" );
+      result = false;
+    }
+    _exit( result ? 0 : 1 );
+  }
+  close( errpipe[1] );
+
+  // the child writes the objects, in here they count as saved from now on
+  for ( const auto& objitr : objStorageManager.objecthash )
+  {
+    if ( !objitr.second->orphan() )
+      objitr.second->clear_dirty();
+  }
+  forked_deleted_serials.assign( objStorageManager.objecthash.dirty_deleted_begin(),
+                                 objStorageManager.objecthash.dirty_deleted_end() );
+  Module::advance_datastore_versions();
+  forked_datastore_pending = true;
+  auto blocked_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        Tools::HighPerfTimer::Clock::now() - save_start )
+                        .count();
+  // the incremental saves existing now are replaced once the child succeeded
+  SaveContext::finished =
+      std::async( std::launch::async, wait_for_forked_save, pid, errpipe[0],
+                  objStorageManager.incremental_save_count, save_start, blocked_ms );
+  return true;
+}
+#endif
+}  // namespace
+
+int write_data( unsigned int& dirty_writes, unsigned int& clean_writes, long long& elapsed_ms )
+{
+  SaveContext::ready();  // allow only one active
+  if ( !should_write_data() )
+  {
+    dirty_writes = clean_writes = 0;
+    elapsed_ms = 0;
+    return -1;
+  }
+
+  UObject::dirty_writes = 0;
+  UObject::clean_writes = 0;
+
+  Tools::LatencyTimer blocking_timer( stateManager.tick_histograms.worldsave_blocking );
+  const auto save_start = Tools::HighPerfTimer::Clock::now();
+  Tools::Timer<> timer;
+  bool forked = false;
+#ifndef _WIN32
+  if ( Plib::systemstate.config.fork_worldsave && !forked_save_failed )
+    forked = launch_forked_save( save_start );
+#endif
+  forked_save_failed = false;
+  if ( !forked )
+  {
+    // launch complete save as seperate thread
+    // but wait till the first critical part is finished
+    // which means all objects got written into a format object
+    // the remaining operations are only pure buffered i/o
+    auto critical_promise = std::make_shared<std::promise<bool>>();
+    auto critical_future = critical_promise->get_future();
+    SaveContext::finished = std::async(
+        std::launch::async,
+        [critical_promise, save_start]() -> bool
         {
-          commit( "pol" );
-          commit( "objects" );
-          commit( "pcs" );
-          commit( "pcequip" );
-          commit( "npcs" );
-          commit( "npcequip" );
-          commit( "items" );
-          commit( "multis" );
-          commit( "storage" );
-          commit( "resource" );
-          commit( "guilds" );
-          commit( "datastore" );
-          commit( "parties" );
-        }
-        return true;
-      } );
-  critical_future.wait();  // wait for end of critical part
+          std::atomic<bool> result( true );
+          long long blocked_ms = 0;
+          try
+          {
+            SaveContext sc;
+            std::vector<std::future<bool>> critical_parts;
+            for ( const auto& part : save_parts )
+            {
+              critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+                  [&]()
+                  {
+                    if ( !write_save_part( part, sc ) )
+                      result = false;
+                  } ) );
+            }
+            for ( auto& task : critical_parts )
+              task.wait();
+
+            blocked_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             Tools::HighPerfTimer::Clock::now() - save_start )
+                             .count();
+            critical_promise->set_value( result );  // critical part end
+            // TODO: since promise can only be set one time move it into a method with a dedicated
+            // try block, now when in theory an upper part fails the promise gets never set
+          }  // deconstructor of the SaveContext flushes and joins the queues
+          catch ( std::ios_base::failure& e )
+          {
+            POLLOG_ERRORLN( "failed to save datafiles! {}:{}", e.what(), std::strerror( errno ) );
+            Clib::force_backtrace();
+            result = false;
+          }
+          catch ( ... )
+          {
+            POLLOG_ERRORLN( "failed to save datafiles!" );
+            Clib::force_backtrace();
+            result = false;
+          }
+          if ( result )
+            commit_save();
+          log_save_times( save_start, blocked_ms );
+          return true;
+        } );
+    critical_future.wait();  // wait for end of critical part
+  }
 
   if ( Plib::systemstate.accounts_txt_dirty )  // write accounts extra, since it uses extra thread
                                                // for io operations would be to many threads working
@@ -1265,8 +1440,11 @@ int write_data( unsigned int& dirty_writes, unsigned int& clean_writes, long lon
     Accounts::write_account_data();
   }
 
-  commit_incremental_saves();
-  objStorageManager.incremental_save_count = 0;
+  if ( !forked )  // a forked save commits them once the child succeeded
+  {
+    commit_incremental_saves();
+    objStorageManager.incremental_save_count = 0;
+  }
   timer.stop();
   objStorageManager.objecthash.ClearDeleted();
   // optimize_zones(); // shrink zone vectors TODO this takes way to much time!
@@ -26,6 +26,7 @@
 #include "../plib/uconst.h"
 #include "baseobject.h"
 #include "dynproperties.h"
+#include "globals/network.h"
 #include "globals/state.h"
 #include "globals/uvars.h"
 #include "item/itemdesc.h"
@@ -130,6 +131,7 @@ void UObject::destroy()
     }
 
     set_dirty();  // we will have to write a 'object deleted' directive once
+    networkManager.tooltip_cache.invalidate( serial );
 
     serial =
         0;  // used to set serial_ext to 0.  This way, if debugging, one can find out the old serial
@@ -165,6 +167,18 @@ void UObject::setprop( const std::string& propname, const std::string& propvalue
   proplist_.setprop( propname, propvalue );  // VOID_RETURN
 }
 
+Bscript::BObjectImp* UObject::getpropimp( const std::string& propname ) const
+{
+  return proplist_.getpropimp( propname );
+}
+
+void UObject::setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue )
+{
+  if ( propname[0] != '#' )
+    set_dirty();
+  proplist_.setpropimp( propname, propvalue );
+}
+
 void UObject::eraseprop( const std::string& propname )
 {
   if ( propname[0] != '#' )
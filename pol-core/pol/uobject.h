@@ -157,6 +157,8 @@ public:
 
   bool getprop( const std::string& propname, std::string& propvalue ) const;
   void setprop( const std::string& propname, const std::string& propvalue );
+  Bscript::BObjectImp* getpropimp( const std::string& propname ) const;
+  void setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue );
   void eraseprop( const std::string& propname );
   void copyprops( const UObject& obj );
   void copyprops( const PropertyList& proplist );
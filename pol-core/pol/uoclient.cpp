@@ -24,7 +24,7 @@ namespace Pol
 {
 namespace Core
 {
-UoClientProtocol::UoClientProtocol() : EnableFlowControlPackets( false ) {}
+UoClientProtocol::UoClientProtocol() : EnableFlowControlPackets( false ), CoalesceSendBytes( 16384 ) {}
 size_t UoClientProtocol::estimateSize() const
 {
   return sizeof( UoClientProtocol );
@@ -141,6 +141,8 @@ void load_protocol_entry( const Plib::Package* /*pkg*/, Clib::ConfigElem& elem )
 {
   networkManager.uoclient_protocol.EnableFlowControlPackets =
       elem.remove_bool( "EnableFlowControlPackets" );
+  networkManager.uoclient_protocol.CoalesceSendBytes =
+      elem.remove_ushort( "CoalesceSendBytes", 16384 );
 }
 
 void load_listener_entry( const Plib::Package* /*pkg*/, Clib::ConfigElem& elem )
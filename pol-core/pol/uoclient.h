@@ -72,6 +72,8 @@ public:
   UoClientProtocol();
   size_t estimateSize() const;
   bool EnableFlowControlPackets;
+  // packets of one transmit batch are collected till this size is reached, 0 disables
+  unsigned short CoalesceSendBytes;
 };
 
 class UoClientListener;
@@ -1148,6 +1148,7 @@ BObjectImp* Item::set_script_member_id( const int id, int value )
     return new BLong( cursed() );
   case MBR_DECAYAT:
     decayat_gameclock_ = value;
+    schedule_decay();
     return new BLong( decayat_gameclock_ );
   case MBR_SELLPRICE:
     sellprice( value );
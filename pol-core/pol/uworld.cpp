@@ -36,6 +36,8 @@ void add_item_to_world( Items::Item* item )
 
   item->realm()->add_toplevel_item( *item );
   zone.items.push_back( item );
+  if ( item->decayat() != 0 )
+    zone.decay_queue.push( item->decayat(), item->serial );
 }
 
 void remove_item_from_world( Items::Item* item )
@@ -229,6 +231,8 @@ void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item )
 
     passert( std::find( newzone.items.begin(), newzone.items.end(), item ) == newzone.items.end() );
     newzone.items.push_back( item );
+    if ( item->decayat() != 0 )
+      newzone.decay_queue.push( item->decayat(), item->serial );
   }
 
   if ( oldpos.realm() != item->realm() )
@@ -6,6 +6,10 @@
 
 #include "zone.h"
 
+#include <algorithm>
+
+#include "../clib/stlutil.h"
+
 namespace Pol
 {
 namespace Core
@@ -14,5 +18,32 @@ Pos2d XyToZone( const Pos2d& pos )
 {
   return Pos2d( pos.x() >> ZONE_SHIFT, pos.y() >> ZONE_SHIFT );
 }
+
+namespace
+{
+bool later( const ZoneDecayQueue::Entry& a, const ZoneDecayQueue::Entry& b )
+{
+  return a.when > b.when;
+}
+}  // namespace
+
+void ZoneDecayQueue::push( u32 when, u32 serial )
+{
+  _heap.push_back( Entry{ when, serial } );
+  std::push_heap( _heap.begin(), _heap.end(), later );
+}
+
+ZoneDecayQueue::Entry ZoneDecayQueue::pop()
+{
+  std::pop_heap( _heap.begin(), _heap.end(), later );
+  Entry entry = _heap.back();
+  _heap.pop_back();
+  return entry;
+}
+
+size_t ZoneDecayQueue::sizeEstimate() const
+{
+  return Clib::memsize( _heap );
+}
 }  // namespace Core
 }  // namespace Pol
@@ -8,6 +8,7 @@
 #define ZONE_H
 #include <vector>
 
+#include "../clib/rawtypes.h"
 #include "base/position.h"
 
 namespace Pol
@@ -38,12 +39,40 @@ typedef std::vector<Mobile::Character*> ZoneCharacters;
 typedef std::vector<Multi::UMulti*> ZoneMultis;
 typedef std::vector<Items::Item*> ZoneItems;
 
+// min-heap of the decay deadlines (gameclock) of the toplevel items in a zone.
+// Entries are pushed whenever an item enters the zone or its deadline changes, outdated
+// entries are not removed but get validated by the decay sweep once they are due.
+class ZoneDecayQueue
+{
+public:
+  struct Entry
+  {
+    u32 when;
+    u32 serial;
+    bool operator==( const Entry& other ) const
+    {
+      return when == other.when && serial == other.serial;
+    }
+  };
+
+  void push( u32 when, u32 serial );
+  bool due( u32 gameclock ) const { return !_heap.empty() && gameclock > _heap.front().when; }
+  Entry pop();
+  void clear() { _heap.clear(); }
+  size_t size() const { return _heap.size(); }
+  size_t sizeEstimate() const;
+
+private:
+  std::vector<Entry> _heap;
+};
+
 struct Zone
 {
   ZoneCharacters characters;
   ZoneCharacters npcs;
   ZoneItems items;
   ZoneMultis multis;
+  ZoneDecayQueue decay_queue;
 };
 
 }  // namespace Core
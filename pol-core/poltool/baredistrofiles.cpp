@@ -624,7 +624,23 @@ void BareDistro::distro_files( std::map<fs::path, std::vector<std::string>>& dis
 "# Used by functions like WalkToward, RunAwayFrom and similar.",
 "# Lower the value to increase maximum speed of all NPCs. It is halved for running.",
 "#",
-"NpcMinimumMovementDelay=250"
+"NpcMinimumMovementDelay=250",
+"",
+"#",
+"# TooltipCacheSize - (default 10000)",
+"#",
+"# Maximum number of prebuilt AOS tooltip packets (0xD6) kept in memory.",
+"# A cached packet is reused as long as the revision of the object does not change. 0 disables the cache.",
+"#",
+"TooltipCacheSize=10000",
+"",
+"#",
+"# GumpCacheSize - (default 1000)",
+"#",
+"# Maximum number of compressed gump layouts (0xDD) kept in memory.",
+"# Dialogs sent with the same layout to many players are compressed only once. 0 disables the cache.",
+"#",
+"GumpCacheSize=1000"
                   } ) );
 
   distro.emplace( "config/startloc.cfg",
@@ -45,6 +45,9 @@ const LISTENPT_NO_SPEECH        := 0x04;    // hear no normal speech (only with
 const ITEMS_IGNORE_STATICS      := 0x01;    // Don't list Static Items
 const ITEMS_IGNORE_MULTIS       := 0x02;    // Don't list Multi Items
 
+// SaveWorldState flags
+const SAVE_INCREMENTAL          := 0x01;    // only save objects changed since the last save
+
 // special value for List[Items/Mobiles/Statics]*
 const LIST_IGNORE_Z             := 0x40000000; // Ignore Z-Value and list everything
 
@@ -376,7 +379,7 @@ ReserveItem( item );
 RestartScript( npc_or_item );
 Resurrect( mobile, flags := 0 ); // flags: RESURRECT_*
 RevokePrivilege( character, privilege );
-SaveWorldState();
+SaveWorldState( flags := 0 ); // flags: SAVE_*
 SecureTradeWin( character, character2 );
 SelectColor( character, item );
 SelectMenuItem2( character, menuname );